@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+"""Compare two bench_app results and fail on a slowdown.
+
+usage: compare.py BASELINE CURRENT [--threshold PCT]
+
+Each file is a captured bench_app log (or just its JSON line); the last
+line starting with {"bench" is used. A kernel/flush pair whose median
+ns per pixel grew by more than PCT percent (default 10) is a regression,
+and the exit status is 1. Only compare runs from the same machine.
+"""
+import argparse
+import json
+import sys
+
+
+def load(path):
+    result = None
+    with open(path, encoding='utf-8', errors='replace') as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith('{"bench"'):
+                result = json.loads(line)
+    if result is None:
+        sys.exit(f'{path}: no bench_app JSON line found')
+    return {(r['kernel'], r['case']): r for r in result['results']}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('baseline')
+    parser.add_argument('current')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='allowed slowdown in percent (default 10)')
+    args = parser.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+    regressions = 0
+    print(f'{"kernel":<8} {"flush":<12} {"base ns/px":>10} {"ns/px":>8} {"change":>8}')
+    for key in sorted(base.keys() & cur.keys()):
+        b = base[key]['ns_per_pixel']
+        c = cur[key]['ns_per_pixel']
+        change = (c - b) / b * 100.0
+        slow = change > args.threshold
+        regressions += slow
+        print(f'{key[0]:<8} {key[1]:<12} {b:>10.3f} {c:>8.3f} {change:>+7.1f}%'
+              + ('  REGRESSION' if slow else ''))
+    for key in sorted(base.keys() ^ cur.keys()):
+        print(f'{key[0]:<8} {key[1]:<12} only in {"baseline" if key in base else "current"}')
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,307 @@
+/**
+ * bench_main.c — ili9486 pixel pipeline micro-benchmark
+ *
+ * Times every RGB565 -> RGB666 kernel over the flush sizes LVGL produces
+ * (one row, an 80-row band, the full screen) and models how long the same
+ * flush takes on the SPI bus, to show whether a configuration is bound by
+ * the CPU or by the bus. Rotated flushes are timed both ways: rotated
+ * into a frame first, as LVGL's sw_rotate does, then converted; and
+ * rotated while converting, by the fused kernel. Indexed bitmaps are
+ * timed expanding straight to RGB666 through a palette.
+ *
+ * On the host:
+ *   idf.py -C bench_app --preview set-target linux
+ *   idf.py -C bench_app build monitor
+ * or build and flash it for a chip to get on-target numbers.
+ *
+ * The last line printed is the whole result as one JSON object;
+ * bench_app/compare.py checks one against a baseline.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "sdkconfig.h"
+#include "esp_ili9486_convert.h"
+
+#define LCD_W    320
+#define LCD_H    480
+#define SAMPLES  15
+
+// Wire bytes of a flush besides its pixels: CASET and RASET, each with
+// four parameters padded to 16-bit words, and RAMWR
+#define SETUP_BYTES           (2 * (1 + 8) + 1)
+#define WIRE_BYTES_PER_PIXEL  3
+
+typedef struct {
+    const char *name;
+    int pixels;
+} bench_case_t;
+
+static const bench_case_t s_cases[] = {
+    { "row",         LCD_W },
+    { "band_80",     LCD_W * 80 },
+    { "full_screen", LCD_W * LCD_H },
+};
+
+// Lower bound for any kernel: writes the same bytes with no work per
+// pixel (the source buffers hold 3 bytes per pixel to allow it)
+static void bench_memcpy(const uint16_t *src, uint8_t *dst, size_t pixels)
+{
+    memcpy(dst, src, pixels * WIRE_BYTES_PER_PIXEL);
+}
+
+// How a flush is converted
+typedef enum {
+    BENCH_STRAIGHT,     // fn, chunk by chunk
+    BENCH_ROT_2PASS,    // rotated 90 degrees into a frame, then fn
+    BENCH_ROT_FUSED,    // rotated by the fused kernel, band by band
+    BENCH_INDEXED,      // bits-wide palette indices, chunk by chunk
+} bench_mode_t;
+
+typedef struct {
+    const char *name;
+    bench_mode_t mode;
+    ili9486_conv_fn_t fn;
+    int bits;
+} bench_kernel_t;
+
+static const bench_kernel_t s_kernels[] = {
+    { "scalar",    BENCH_STRAIGHT,  ili9486_rgb565_to_rgb666_ref,  0 },
+    { "word",      BENCH_STRAIGHT,  ili9486_rgb565_to_rgb666_word, 0 },
+    { "lut",       BENCH_STRAIGHT,  ili9486_rgb565_to_rgb666_lut,  0 },
+    { "memcpy",    BENCH_STRAIGHT,  bench_memcpy,                  0 },
+    // The fused kernel packs words like "word", so the two-pass path
+    // converts with it too
+    { "rot_2pass", BENCH_ROT_2PASS, ili9486_rgb565_to_rgb666_word, 0 },
+    { "rot_fused", BENCH_ROT_FUSED, NULL,                          0 },
+    { "index_8",   BENCH_INDEXED,   NULL,                          8 },
+    { "index_4",   BENCH_INDEXED,   NULL,                          4 },
+    { "index_1",   BENCH_INDEXED,   NULL,                          1 },
+};
+
+// Rotated flushes: LCD_W source pixels per row, turned clockwise
+#define ROT_XFORM (ILI9486_XFORM_SWAP_XY | ILI9486_XFORM_MIRROR_X)
+
+#define N_CASES   (sizeof(s_cases) / sizeof(s_cases[0]))
+#define N_KERNELS (sizeof(s_kernels) / sizeof(s_kernels[0]))
+
+typedef struct {
+    double ns_per_pixel;        // median of the samples
+    double ns_per_pixel_min;
+    double conv_us;             // one flush
+    double bus_us;
+    double flush_us_serial;     // convert, then send, chunk by chunk
+    double flush_us_pipelined;  // next chunk converted while one is sent
+} bench_result_t;
+
+static volatile uint8_t s_sink;
+static uint16_t *s_rotated;     // frame of the two-pass rotation
+static uint32_t s_palette[256]; // RGB666 wire bytes per index
+
+static uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// One flush as the driver converts it: chunk by chunk into one buffer
+static void bench_convert(ili9486_conv_fn_t fn, const uint16_t *src, uint8_t *dst, int pixels)
+{
+    for (int done = 0; done < pixels; done += CONFIG_BENCH_CHUNK_PIXELS) {
+        int n = pixels - done;
+        if (n > CONFIG_BENCH_CHUNK_PIXELS) {
+            n = CONFIG_BENCH_CHUNK_PIXELS;
+        }
+        fn(src + done, dst, n);
+    }
+}
+
+// Clockwise, the way sw_rotate walks it: along the source rows
+static void bench_rotate(const uint16_t *src, int w, int h, uint16_t *dst)
+{
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            dst[x * h + h - 1 - y] = src[y * w + x];
+        }
+    }
+}
+
+// Output rows of the rotated flush (h pixels each) per conversion chunk
+static void bench_convert_rotated(const uint16_t *src, int h, uint8_t *dst)
+{
+    int band = CONFIG_BENCH_CHUNK_PIXELS / h;
+    if (band < 1) {
+        band = 1;
+    }
+    for (int row = 0; row < LCD_W; row += band) {
+        int n = LCD_W - row < band ? LCD_W - row : band;
+        ili9486_rgb565_to_rgb666_xform(src, LCD_W, LCD_W, h, ROT_XFORM, row, n, dst);
+    }
+}
+
+static void bench_convert_indexed(const uint8_t *src, int bits, uint8_t *dst, int pixels)
+{
+    for (int done = 0; done < pixels; done += CONFIG_BENCH_CHUNK_PIXELS) {
+        int n = pixels - done;
+        if (n > CONFIG_BENCH_CHUNK_PIXELS) {
+            n = CONFIG_BENCH_CHUNK_PIXELS;
+        }
+        ili9486_index_to_wire(src, done, bits, s_palette, WIRE_BYTES_PER_PIXEL, dst, n);
+    }
+}
+
+static void bench_flush(const bench_kernel_t *k, const uint16_t *src, uint8_t *dst, int pixels)
+{
+    switch (k->mode) {
+    case BENCH_STRAIGHT:
+        bench_convert(k->fn, src, dst, pixels);
+        break;
+    case BENCH_ROT_2PASS:
+        bench_rotate(src, LCD_W, pixels / LCD_W, s_rotated);
+        bench_convert(k->fn, s_rotated, dst, pixels);
+        break;
+    case BENCH_ROT_FUSED:
+        bench_convert_rotated(src, pixels / LCD_W, dst);
+        break;
+    case BENCH_INDEXED:
+        bench_convert_indexed((const uint8_t *)src, k->bits, dst, pixels);
+        break;
+    }
+    s_sink = dst[0];
+}
+
+static double bench_sample(const bench_kernel_t *k, const uint16_t *src, uint8_t *dst,
+                           int pixels, int iters)
+{
+    uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < iters; i++) {
+        bench_flush(k, src, dst, pixels);
+    }
+    return (double)(bench_now_ns() - t0) / iters / pixels;
+}
+
+static int bench_cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_run(const bench_kernel_t *k, const uint16_t *src, uint8_t *dst, int pixels,
+                      bench_result_t *res)
+{
+    const uint64_t sample_ns = (uint64_t)CONFIG_BENCH_MIN_TIME_MS * 1000000ull / SAMPLES;
+    double samples[SAMPLES];
+
+    // Warm the caches (and the LUT), then size the samples
+    bench_flush(k, src, dst, pixels);
+    int iters = 1;
+    double ns = bench_sample(k, src, dst, pixels, iters);
+    if (ns * pixels < sample_ns) {
+        iters = (int)(sample_ns / (ns * pixels)) + 1;
+    }
+    for (int i = 0; i < SAMPLES; i++) {
+        samples[i] = bench_sample(k, src, dst, pixels, iters);
+    }
+    qsort(samples, SAMPLES, sizeof(samples[0]), bench_cmp_double);
+
+    res->ns_per_pixel     = samples[SAMPLES / 2];
+    res->ns_per_pixel_min = samples[0];
+
+    // Bus model: every byte at the pixel clock, no gaps between transfers
+    const int chunk = pixels < CONFIG_BENCH_CHUNK_PIXELS ? pixels : CONFIG_BENCH_CHUNK_PIXELS;
+    res->conv_us = res->ns_per_pixel * pixels / 1000.0;
+    res->bus_us  = (SETUP_BYTES + (double)pixels * WIRE_BYTES_PER_PIXEL) * 8.0 * 1e6 /
+                   CONFIG_BENCH_PIXEL_CLK_HZ;
+    res->flush_us_serial = res->conv_us + res->bus_us;
+    res->flush_us_pipelined = (res->conv_us > res->bus_us ? res->conv_us : res->bus_us) +
+                              res->ns_per_pixel * chunk / 1000.0;
+}
+
+static const char *bench_bound(const bench_result_t *res)
+{
+    return res->conv_us > res->bus_us ? "cpu" : "spi";
+}
+
+void app_main(void)
+{
+    static bench_result_t results[N_KERNELS][N_CASES];
+    const int max_pixels = LCD_W * LCD_H;
+    const char *selected = ili9486_conv_name(ili9486_conv_select());
+
+    // A rotated one-row flush converts a single column: LCD_H at most
+    const int chunk_max = CONFIG_BENCH_CHUNK_PIXELS > LCD_H ? CONFIG_BENCH_CHUNK_PIXELS : LCD_H;
+    uint16_t *src = malloc(max_pixels * WIRE_BYTES_PER_PIXEL);
+    uint8_t  *dst = malloc(chunk_max * WIRE_BYTES_PER_PIXEL);
+    s_rotated = malloc(max_pixels * sizeof(uint16_t));
+    if (!src || !dst || !s_rotated) {
+        printf("bench: no memory for a %d-pixel frame (needs PSRAM on a chip)\n", max_pixels);
+        return;
+    }
+    srand(1);
+    for (int i = 0; i < max_pixels * WIRE_BYTES_PER_PIXEL / 2; i++) {
+        src[i] = (uint16_t)rand();
+    }
+    for (int i = 0; i < 256; i++) {
+        s_palette[i] = (uint32_t)rand() & 0xFFFFFF;
+    }
+
+    printf("\nili9486 pixel pipeline, target %s, selected kernel \"%s\"\n",
+           CONFIG_IDF_TARGET, selected);
+    printf("bus model: %d Hz, %d setup bytes per flush, %d-pixel conversion buffer\n\n",
+           CONFIG_BENCH_PIXEL_CLK_HZ, SETUP_BYTES, CONFIG_BENCH_CHUNK_PIXELS);
+    printf("%-10s %-12s %9s %9s %9s %10s %10s %5s\n", "kernel", "flush", "ns/px",
+           "MB/s", "conv us", "bus us", "pipe us", "bound");
+
+    for (size_t k = 0; k < N_KERNELS; k++) {
+        for (size_t c = 0; c < N_CASES; c++) {
+            bench_result_t *r = &results[k][c];
+            bench_run(&s_kernels[k], src, dst, s_cases[c].pixels, r);
+            printf("%-10s %-12s %9.3f %9.1f %9.1f %10.1f %10.1f %5s\n",
+                   s_kernels[k].name, s_cases[c].name, r->ns_per_pixel,
+                   WIRE_BYTES_PER_PIXEL * 1000.0 / r->ns_per_pixel, r->conv_us, r->bus_us,
+                   r->flush_us_pipelined, bench_bound(r));
+        }
+    }
+
+    const bench_result_t *full = &results[0][N_CASES - 1];
+    printf("\nfull screen on the bus alone: %.1f fps\n", 1e6 / full->bus_us);
+    double two_pass = 0, fused = 0;
+    for (size_t k = 0; k < N_KERNELS; k++) {
+        if (s_kernels[k].mode == BENCH_ROT_2PASS) two_pass = results[k][N_CASES - 1].ns_per_pixel;
+        if (s_kernels[k].mode == BENCH_ROT_FUSED) fused    = results[k][N_CASES - 1].ns_per_pixel;
+    }
+    printf("rotated full screen: fused %.2fx the speed of rotate + convert "
+           "(memory traffic 5 vs 9 bytes per pixel)\n\n", two_pass / fused);
+
+    // Machine-readable copy, one line
+    printf("{\"bench\":\"ili9486_pixel_pipeline\",\"version\":1,\"target\":\"%s\","
+           "\"kernel_selected\":\"%s\",\"pixel_clk_hz\":%d,\"chunk_pixels\":%d,"
+           "\"setup_bytes\":%d,\"results\":[",
+           CONFIG_IDF_TARGET, selected, CONFIG_BENCH_PIXEL_CLK_HZ,
+           CONFIG_BENCH_CHUNK_PIXELS, SETUP_BYTES);
+    for (size_t k = 0; k < N_KERNELS; k++) {
+        for (size_t c = 0; c < N_CASES; c++) {
+            const bench_result_t *r = &results[k][c];
+            printf("%s{\"kernel\":\"%s\",\"case\":\"%s\",\"pixels\":%d,"
+                   "\"ns_per_pixel\":%.4f,\"ns_per_pixel_min\":%.4f,\"mb_per_s\":%.2f,"
+                   "\"conv_us\":%.2f,\"bus_us\":%.2f,\"flush_us_serial\":%.2f,"
+                   "\"flush_us_pipelined\":%.2f,\"bound\":\"%s\"}",
+                   (k || c) ? "," : "", s_kernels[k].name, s_cases[c].name,
+                   s_cases[c].pixels, r->ns_per_pixel, r->ns_per_pixel_min,
+                   WIRE_BYTES_PER_PIXEL * 1000.0 / r->ns_per_pixel, r->conv_us,
+                   r->bus_us, r->flush_us_serial, r->flush_us_pipelined, bench_bound(r));
+        }
+    }
+    printf("]}\n");
+
+    free(src);
+    free(dst);
+    free(s_rotated);
+#if CONFIG_IDF_TARGET_LINUX
+    fflush(stdout);
+    exit(0);
+#endif
+}
@@ -93,8 +93,8 @@ esp_err_t ili9486_display_init(void)
     ESP_ERROR_CHECK(esp_lcd_panel_reset(s_panel));
     ESP_ERROR_CHECK(esp_lcd_panel_init(s_panel));
     
-    // Force BGR bit in MADCTL (bit 3) for correct color rendering
-    esp_lcd_panel_io_tx_param(s_io_handle, 0x36, (uint8_t[]){ 0x48 }, 1);
+    // Upright portrait; the driver keeps the BGR bit for correct colours
+    ESP_ERROR_CHECK(esp_lcd_panel_ili9486_set_orientation(s_panel, ILI9486_ORIENTATION_0));
 
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(s_panel, true));
 
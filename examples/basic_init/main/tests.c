@@ -35,16 +35,12 @@ static const char *TAG = "TESTS";
 static uint16_t row_buf[LCD_W];
 
 // ── Fill a rectangle with a solid colour ─────────────────────────────────────
+// Inclusive corners; the driver fill streams a pattern, no row buffer needed
 static void fill_rect(esp_lcd_panel_handle_t panel,
                       int x0, int y0, int x1, int y1,
                       uint16_t colour)
 {
-    int w = x1 - x0 + 1;
-    for (int i = 0; i < w; i++) row_buf[i] = colour;
-
-    for (int y = y0; y <= y1; y++) {
-        esp_lcd_panel_draw_bitmap(panel, x0, y, x1 + 1, y + 1, row_buf);
-    }
+    esp_lcd_panel_ili9486_fill_rect(panel, x0, y0, x1 + 1, y1 + 1, colour);
 }
 
 // ── Fill entire screen ────────────────────────────────────────────────────────
@@ -41,10 +41,9 @@ static esp_lcd_panel_io_handle_t s_io_handle = NULL;
 static esp_lcd_panel_handle_t   s_panel      = NULL;
 static lv_display_t             *s_disp      = NULL;  // <-- ADD THIS
 
-static bool ili9486_color_trans_done_cb(
-    esp_lcd_panel_io_handle_t panel_io,
-    esp_lcd_panel_io_event_data_t *edata,
-    void *user_ctx)
+// The driver has converted the pixels into its own buffer, so LVGL can
+// render the next band while this one is still on the wire.
+static bool ili9486_src_released_cb(esp_lcd_panel_handle_t panel, void *user_ctx)
 {
     lvgl_port_flush_ready(user_ctx);
     return false;
@@ -109,24 +108,30 @@ esp_err_t ili9486_display_init(lv_display_t** handle)
         TAG, "Panel create failed");
 
     ESP_ERROR_CHECK(esp_lcd_panel_reset(s_panel));
-    ESP_ERROR_CHECK(esp_lcd_panel_init(s_panel));
 
-    // Force BGR bit in MADCTL (bit 3)
-    esp_lcd_panel_io_tx_param(s_io_handle, 0x36,
-        (uint8_t[]){ 0x48 }, 1);   // MX=1, BGR=1 → portrait + correct colours
+    // The init sequence spends ~125 ms waiting on the panel: start it,
+    // bring LVGL up meanwhile, then send the rest once it is due
+    ESP_ERROR_CHECK(esp_lcd_panel_ili9486_init_begin(s_panel));
 
+    /* ── LVGL ──────────────────────────────────────────────────────────────── */
+    ESP_LOGI(TAG, "Initialize LVGL");
+    const lvgl_port_cfg_t lvgl_cfg = ESP_LVGL_PORT_INIT_CONFIG();
+    lvgl_port_init(&lvgl_cfg);
 
-    //ESP_ERROR_CHECK(esp_lcd_panel_mirror(s_panel, true, false));  // mirror X only
+    uint32_t wait_us;
+    while ((ret = esp_lcd_panel_ili9486_init_poll(s_panel, &wait_us)) == ESP_ERR_NOT_FINISHED) {
+        vTaskDelay(pdMS_TO_TICKS(wait_us / 1000) + 1);
+    }
+    ESP_ERROR_CHECK(ret);
+
+    // Upright portrait; the driver keeps the BGR bit
+    ESP_ERROR_CHECK(esp_lcd_panel_ili9486_set_orientation(s_panel, ILI9486_ORIENTATION_0));
     ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(s_panel, true));
 
     /* Backlight ON */
     gpio_set_level(PIN_NUM_BK_LIGHT, 1);
 
-    /* ── LVGL ──────────────────────────────────────────────────────────────── */
-    ESP_LOGI(TAG, "Initialize LVGL");
-    const lvgl_port_cfg_t lvgl_cfg = ESP_LVGL_PORT_INIT_CONFIG();
-    lvgl_port_init(&lvgl_cfg);
-
+    /* ── LVGL display ──────────────────────────────────────────────────────── */
     const lvgl_port_display_cfg_t disp_cfg = {
         .io_handle     = s_io_handle,
         .panel_handle  = s_panel,           // ← valid handle, no crash
@@ -138,6 +143,8 @@ esp_err_t ili9486_display_init(lv_display_t** handle)
 #if LVGL_VERSION_MAJOR >= 9
         .color_format  = LV_COLOR_FORMAT_RGB565,
 #endif
+        // Must match ILI9486_ORIENTATION_0: the port replays it through
+        // swap_xy() / mirror() whenever the LVGL rotation changes
         .rotation = {
             .swap_xy  = false,
             .mirror_x = true,
@@ -147,7 +154,7 @@ esp_err_t ili9486_display_init(lv_display_t** handle)
 #if LVGL_VERSION_MAJOR >= 9
             .swap_bytes = false,   // ILI9486 is big-endian; LVGL is little-endian
 #endif
-            .sw_rotate  = false,
+            .sw_rotate  = false,   // see ili9486_display_set_rotation()
         }
     };
     
@@ -155,6 +162,13 @@ esp_err_t ili9486_display_init(lv_display_t** handle)
     s_disp = lvgl_port_add_disp(&disp_cfg);  // <-- was: lvgl_port_add_disp(&disp_cfg);
     *handle = s_disp;
 
+    // Must come after lvgl_port_add_disp(): it replaces the IO callback the
+    // port installed, which would only fire once the whole flush is sent.
+    const esp_lcd_panel_ili9486_callbacks_t panel_cbs = {
+        .on_src_released = ili9486_src_released_cb,
+    };
+    ESP_ERROR_CHECK(esp_lcd_panel_ili9486_register_event_callbacks(s_panel, &panel_cbs, s_disp));
+
 
 
 //    vTaskDelay(pdMS_TO_TICKS(3000));   // wait for LVGL to flush the first frame before setting resolution
@@ -167,6 +181,21 @@ esp_err_t ili9486_display_init(lv_display_t** handle)
 
 
 
+// Rotate the UI in hardware. LVGL renders straight into the rotated
+// layout and MADCTL turns it on the panel, so flushes skip the extra copy
+// of sw_rotate.
+esp_err_t ili9486_display_set_rotation(lv_display_t *disp, lv_display_rotation_t rotation)
+{
+    ESP_RETURN_ON_FALSE(s_panel && disp, ESP_ERR_INVALID_STATE, TAG, "display not initialized");
+    ESP_RETURN_ON_FALSE(lvgl_port_lock(0), ESP_ERR_TIMEOUT, TAG, "LVGL lock failed");
+    // The port answers the resolution change with swap_xy() and mirror();
+    // the orientation then sets the final MADCTL in one write
+    lv_display_set_rotation(disp, rotation);
+    esp_err_t ret = esp_lcd_panel_ili9486_set_orientation(s_panel, (ili9486_orientation_t)rotation);
+    lvgl_port_unlock();
+    return ret;
+}
+
 esp_lcd_panel_handle_t ili9486_display_get_panel(void)
 {
     if(!s_panel) {
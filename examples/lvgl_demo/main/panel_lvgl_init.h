@@ -11,6 +11,9 @@ extern "C" {
 
 esp_err_t ili9486_display_init(lv_display_t** handle);
 
+// Hardware rotation: lv_display_set_rotation() plus the matching MADCTL
+esp_err_t ili9486_display_set_rotation(lv_display_t *disp, lv_display_rotation_t rotation);
+
 esp_lcd_panel_io_handle_t ili9486_display_get_panel_io(void);
 
 
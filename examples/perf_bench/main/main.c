@@ -0,0 +1,126 @@
+/**
+ * main.c — ILI9486 perf_bench example
+ *
+ * Runs a standard scene set (full-screen refresh, small dirty rectangles,
+ * scrolling text, a large image blit) and reports frames per second,
+ * average / p99 flush latency, time blocked in draw_bitmap() against wire
+ * time, and SPI throughput against CONFIG_ILI9486_PIXEL_CLK_HZ.
+ *
+ * With CONFIG_PERF_BENCH_MOCK_IO the panel IO is the driver's emulator
+ * instead of the SPI bus: no display needed, and the numbers measure the
+ * driver and harness alone.
+ *
+ * Build and flash:
+ *   idf.py -C examples/perf_bench build flash monitor
+ */
+
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_ili9486_panel.h"
+#if CONFIG_PERF_BENCH_MOCK_IO
+#include "esp_ili9486_mock_io.h"
+#else
+#include "driver/spi_master.h"
+#include "driver/gpio.h"
+#endif
+#include "perf_scenes.h"
+
+static const char *TAG = "perf_bench";
+
+#define LCD_H_RES 320
+
+#if CONFIG_PERF_BENCH_MOCK_IO
+
+static esp_err_t perf_bench_new_io(esp_lcd_panel_io_handle_t *io)
+{
+    // Only the traffic counts matter, so skip the 460 KB GRAM
+    const esp_lcd_ili9486_mock_config_t mock_config = {
+        .flags.no_gram = 1,
+    };
+    return esp_lcd_new_panel_io_ili9486_mock(&mock_config, io);
+}
+
+static void perf_bench_backlight(bool on)
+{
+}
+
+#else
+
+static esp_err_t perf_bench_new_io(esp_lcd_panel_io_handle_t *io)
+{
+    spi_bus_config_t buscfg = {
+        .mosi_io_num     = CONFIG_ILI9486_PIN_MOSI,
+        .miso_io_num     = CONFIG_ILI9486_PIN_MISO,
+        .sclk_io_num     = CONFIG_ILI9486_PIN_CLK,
+        .quadwp_io_num   = -1,
+        .quadhd_io_num   = -1,
+        .max_transfer_sz = LCD_H_RES * 80 * 3,
+    };
+    ESP_RETURN_ON_ERROR(spi_bus_initialize(CONFIG_ILI9486_SPI_HOST, &buscfg, SPI_DMA_CH_AUTO),
+                        TAG, "SPI bus init failed");
+
+    esp_lcd_panel_io_spi_config_t io_config = {
+        .dc_gpio_num       = CONFIG_ILI9486_PIN_DC,
+        .cs_gpio_num       = CONFIG_ILI9486_PIN_CS,
+        .pclk_hz           = CONFIG_ILI9486_PIXEL_CLK_HZ,
+        .lcd_cmd_bits      = 8,
+        .lcd_param_bits    = 8,
+        .spi_mode          = 0,
+        .trans_queue_depth = 10,
+    };
+    return esp_lcd_new_panel_io_spi((esp_lcd_spi_bus_handle_t)CONFIG_ILI9486_SPI_HOST,
+                                    &io_config, io);
+}
+
+static void perf_bench_backlight(bool on)
+{
+    const gpio_config_t bk_conf = {
+        .mode         = GPIO_MODE_OUTPUT,
+        .pin_bit_mask = 1ULL << CONFIG_ILI9486_PIN_BL,
+    };
+    gpio_config(&bk_conf);
+    gpio_set_level(CONFIG_ILI9486_PIN_BL, on);
+}
+
+#endif
+
+void app_main(void)
+{
+    esp_lcd_panel_io_handle_t io = NULL;
+    esp_lcd_panel_handle_t panel = NULL;
+
+    ESP_LOGI(TAG, "ILI9486 perf bench");
+    ESP_ERROR_CHECK(perf_bench_new_io(&io));
+
+    const esp_lcd_panel_dev_config_t panel_config = {
+#if CONFIG_PERF_BENCH_MOCK_IO
+        .reset_gpio_num = -1,
+#else
+        .reset_gpio_num = CONFIG_ILI9486_PIN_RST,
+#endif
+        .bits_per_pixel = 16,
+    };
+    ESP_ERROR_CHECK(esp_lcd_new_panel_ili9486(io, &panel_config, &panel));
+    ESP_ERROR_CHECK(esp_lcd_panel_reset(panel));
+    ESP_ERROR_CHECK(esp_lcd_panel_init(panel));
+    ESP_ERROR_CHECK(esp_lcd_panel_disp_on_off(panel, true));
+    perf_bench_backlight(true);
+
+    const perf_config_t cfg = {
+        .panel                = panel,
+        .io_name              = CONFIG_PERF_BENCH_MOCK_IO ? "mock" : "spi",
+        .pixel_clk_hz         = CONFIG_ILI9486_PIXEL_CLK_HZ,
+        .wire_bytes_per_pixel = 3,      // RGB666, the default pixel format
+        .scene_ms             = CONFIG_PERF_BENCH_SCENE_MS,
+    };
+    ESP_ERROR_CHECK(perf_run_scenes(&cfg, NULL));
+
+    esp_lcd_panel_del(panel);
+    esp_lcd_panel_io_del(io);
+    ESP_LOGI(TAG, "done");
+}
@@ -0,0 +1,387 @@
+// ─── perf_scenes.c ──────────────────────────────────────────────────────────
+// Scene set and measurements for the perf_bench example. Only the esp_lcd
+// panel API and the driver's callbacks are used, so the harness runs the
+// same on the SPI bus and on the emulated panel IO.
+//
+// Every flush is timed from the draw_bitmap() call to its on_flush_done
+// (latency) and to the return of draw_bitmap() (time the caller was
+// blocked: conversion, plus waiting for the bus when it is busy). Wire
+// time is what the same bytes take at the pixel clock. The source buffers
+// stay unchanged while a scene runs, so no draw has to wait for
+// on_src_released.
+//
+// With CONFIG_ILI9486_ENABLE_STATS the driver's own counters are reset
+// for each scene and reported next to these: conversion cycles per
+// pixel, and the queue and wire time it measured itself.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_ili9486_panel.h"
+#include "perf_scenes.h"
+
+static const char *TAG = "perf";
+
+#define LCD_W            320
+#define LCD_H            480
+#define BAND_ROWS        24         // full refresh in 20 bands
+#define RECT_SIZE        32
+#define RECTS_PER_FRAME  8
+#define TEXT_ROWS        16
+#define IMAGE_SIZE       160
+#define MAX_FLUSHES      2048       // per scene; later flushes are not timed
+#define DRAIN_TIMEOUT_US 1000000
+
+// Wire bytes of a flush besides its pixels: CASET and RASET with padded
+// parameters, and RAMWR
+#define SETUP_BYTES      (2 * (1 + 8) + 1)
+
+typedef struct {
+    uint16_t *band[2];
+    uint16_t *rect;
+    uint16_t *text[2];
+    uint16_t *image;
+} perf_assets_t;
+
+typedef struct {
+    const perf_config_t *cfg;
+    const perf_assets_t *assets;
+    int64_t start_us[MAX_FLUSHES];
+    volatile int64_t done_us[MAX_FLUSHES];
+    uint32_t flushes;
+    volatile uint32_t done;
+    uint32_t frames;
+    uint64_t pixels;
+    int64_t draw_us;
+    uint32_t seed;
+} perf_run_t;
+
+typedef struct {
+    const char *name;
+    esp_err_t (*begin)(perf_run_t *run);
+    void (*frame)(perf_run_t *run);
+    void (*end)(perf_run_t *run);
+} perf_scene_t;
+
+static perf_run_t s_run;
+
+static bool perf_on_flush_done(esp_lcd_panel_handle_t panel, void *user_ctx)
+{
+    perf_run_t *run = user_ctx;
+    uint32_t i = run->done;
+    if (i < MAX_FLUSHES) {
+        run->done_us[i] = esp_timer_get_time();
+    }
+    run->done = i + 1;
+    return false;
+}
+
+static void perf_draw(perf_run_t *run, int x, int y, int w, int h, const uint16_t *src)
+{
+    int64_t t0 = esp_timer_get_time();
+    if (run->flushes < MAX_FLUSHES) {
+        run->start_us[run->flushes] = t0;
+    }
+    run->flushes++;
+    esp_lcd_panel_draw_bitmap(run->cfg->panel, x, y, x + w, y + h, src);
+    run->draw_us += esp_timer_get_time() - t0;
+    run->pixels  += (uint64_t)w * h;
+}
+
+static uint32_t perf_rand(perf_run_t *run)
+{
+    run->seed = run->seed * 1664525u + 1013904223u;
+    return run->seed >> 8;
+}
+
+// ── Scenes ───────────────────────────────────────────────────────────────────
+
+// Full-screen refresh band by band, like LVGL with a 1/20 screen buffer
+static void scene_fill_frame(perf_run_t *run)
+{
+    const uint16_t *band = run->assets->band[run->frames & 1];
+    for (int y = 0; y < LCD_H; y += BAND_ROWS) {
+        perf_draw(run, 0, y, LCD_W, BAND_ROWS, band);
+    }
+}
+
+// Small widgets updating all over the screen
+static void scene_rects_frame(perf_run_t *run)
+{
+    for (int i = 0; i < RECTS_PER_FRAME; i++) {
+        int x = perf_rand(run) % (LCD_W - RECT_SIZE);
+        int y = perf_rand(run) % (LCD_H - RECT_SIZE);
+        perf_draw(run, x, y, RECT_SIZE, RECT_SIZE, run->assets->rect);
+    }
+}
+
+// Log view: hardware-scroll one text line, draw the line it exposes
+static esp_err_t scene_scroll_begin(perf_run_t *run)
+{
+    return esp_lcd_panel_ili9486_scroll_define(run->cfg->panel, 0, 0);
+}
+
+static void scene_scroll_frame(perf_run_t *run)
+{
+    int offset = ((run->frames + 1) * TEXT_ROWS) % LCD_H;
+    esp_lcd_panel_ili9486_scroll_to(run->cfg->panel, offset);
+    perf_draw(run, 0, LCD_H - TEXT_ROWS, LCD_W, TEXT_ROWS,
+              run->assets->text[run->frames & 1]);
+}
+
+static void scene_scroll_end(perf_run_t *run)
+{
+    esp_lcd_panel_ili9486_scroll_stop(run->cfg->panel);
+}
+
+// Large image moved around in one flush
+static void scene_image_frame(perf_run_t *run)
+{
+    int x = (run->frames * 37) % (LCD_W - IMAGE_SIZE);
+    int y = (run->frames * 53) % (LCD_H - IMAGE_SIZE);
+    perf_draw(run, x, y, IMAGE_SIZE, IMAGE_SIZE, run->assets->image);
+}
+
+static const perf_scene_t s_scenes[] = {
+    { "full_fill",   NULL,               scene_fill_frame,   NULL },
+    { "dirty_rects", NULL,               scene_rects_frame,  NULL },
+    { "scroll_text", scene_scroll_begin, scene_scroll_frame, scene_scroll_end },
+    { "image_blit",  NULL,               scene_image_frame,  NULL },
+};
+
+#define N_SCENES (int)(sizeof(s_scenes) / sizeof(s_scenes[0]))
+
+int perf_scene_count(void)
+{
+    return N_SCENES;
+}
+
+// ── Assets ───────────────────────────────────────────────────────────────────
+
+static void perf_assets_free(perf_assets_t *a)
+{
+    heap_caps_free(a->band[0]);
+    heap_caps_free(a->band[1]);
+    heap_caps_free(a->rect);
+    heap_caps_free(a->text[0]);
+    heap_caps_free(a->text[1]);
+    heap_caps_free(a->image);
+}
+
+static esp_err_t perf_assets_init(perf_assets_t *a)
+{
+    // DMA-capable, so the zero-copy pixel formats can send them as they are
+    const uint32_t caps = MALLOC_CAP_DMA;
+    memset(a, 0, sizeof(*a));
+    a->band[0] = heap_caps_malloc(LCD_W * BAND_ROWS * 2, caps);
+    a->band[1] = heap_caps_malloc(LCD_W * BAND_ROWS * 2, caps);
+    a->rect    = heap_caps_malloc(RECT_SIZE * RECT_SIZE * 2, caps);
+    a->text[0] = heap_caps_malloc(LCD_W * TEXT_ROWS * 2, caps);
+    a->text[1] = heap_caps_malloc(LCD_W * TEXT_ROWS * 2, caps);
+    a->image   = heap_caps_malloc(IMAGE_SIZE * IMAGE_SIZE * 2, caps);
+    if (!a->band[0] || !a->band[1] || !a->rect || !a->text[0] || !a->text[1] || !a->image) {
+        perf_assets_free(a);
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (int i = 0; i < LCD_W * BAND_ROWS; i++) {
+        a->band[0][i] = 0x001F;
+        a->band[1][i] = 0xF800;
+    }
+    for (int i = 0; i < RECT_SIZE * RECT_SIZE; i++) {
+        a->rect[i] = 0x07E0;
+    }
+    // Blocky 8 x 12 "glyphs" on a black background
+    for (int t = 0; t < 2; t++) {
+        for (int y = 0; y < TEXT_ROWS; y++) {
+            for (int x = 0; x < LCD_W; x++) {
+                uint32_t h = ((x / 2) * 2654435761u) ^ ((y / 2 + t * 7) * 40503u);
+                bool ink = y >= 2 && y < 14 && (x % 8) != 7 && ((h >> 13) & 1);
+                a->text[t][y * LCD_W + x] = ink ? 0xFFFF : 0x0000;
+            }
+        }
+    }
+    for (int y = 0; y < IMAGE_SIZE; y++) {
+        for (int x = 0; x < IMAGE_SIZE; x++) {
+            uint16_t r = x * 32 / IMAGE_SIZE, g = (x + y) * 32 / IMAGE_SIZE;
+            uint16_t b = y * 32 / IMAGE_SIZE;
+            a->image[y * IMAGE_SIZE + x] = (r << 11) | (g << 5) | b;
+        }
+    }
+    return ESP_OK;
+}
+
+// ── Measurement ──────────────────────────────────────────────────────────────
+
+static int perf_cmp_i64(const void *a, const void *b)
+{
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void perf_driver_stats(const perf_config_t *cfg, perf_result_t *res)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    esp_lcd_panel_ili9486_stats_t st;
+    if (esp_lcd_panel_ili9486_get_stats(cfg->panel, &st) != ESP_OK) {
+        return;
+    }
+    res->conv_cycles_per_px = st.conv_pixels ? (double)st.conv_cycles / st.conv_pixels : 0;
+    res->queue_avg_us       = st.flushes ? (double)st.queue_us_total / st.flushes : 0;
+    res->wire_meas_avg_us   = st.wire_flushes ? (double)st.wire_us_total / st.wire_flushes : 0;
+    res->io_errors          = st.errors;
+#endif
+}
+
+static void perf_summarise(perf_run_t *run, int64_t t0, int64_t t_end, perf_result_t *res)
+{
+    const perf_config_t *cfg = run->cfg;
+    uint32_t timed = run->done < run->flushes ? run->done : run->flushes;
+    if (timed > MAX_FLUSHES) {
+        timed = MAX_FLUSHES;
+    }
+
+    // Latencies, sorted for the percentile; start_us is reused for them
+    int64_t *lat = run->start_us;
+    int64_t sum = 0;
+    for (uint32_t i = 0; i < timed; i++) {
+        lat[i] = run->done_us[i] - run->start_us[i];
+        sum += lat[i];
+    }
+    qsort(lat, timed, sizeof(lat[0]), perf_cmp_i64);
+
+    const double wall_us = (double)(t_end - t0);
+    const double bytes   = (double)run->pixels * cfg->wire_bytes_per_pixel;
+    const double per_px  = run->flushes ? (double)run->pixels / run->flushes : 0;
+
+    res->frames          = run->frames;
+    res->flushes         = run->flushes;
+    res->flushes_lost    = run->flushes - (run->done < run->flushes ? run->done : run->flushes);
+    res->fps             = wall_us > 0 ? run->frames * 1e6 / wall_us : 0;
+    res->latency_avg_us  = timed ? (double)sum / timed : 0;
+    res->latency_p99_us  = timed ? (double)lat[(timed * 99) / 100] : 0;
+    res->draw_avg_us     = run->flushes ? (double)run->draw_us / run->flushes : 0;
+    res->wire_avg_us     = (SETUP_BYTES + per_px * cfg->wire_bytes_per_pixel) * 8e6 /
+                           cfg->pixel_clk_hz;
+    res->throughput_mbps = wall_us > 0 ? bytes / wall_us : 0;
+    res->bus_utilisation = wall_us > 0 ? bytes * 8e6 / wall_us / cfg->pixel_clk_hz : 0;
+    perf_driver_stats(cfg, res);
+}
+
+static esp_err_t perf_run_scene(const perf_config_t *cfg, const perf_assets_t *assets,
+                                const perf_scene_t *scene, perf_result_t *res)
+{
+    perf_run_t *run = &s_run;
+    memset(run, 0, sizeof(*run));
+    run->cfg    = cfg;
+    run->assets = assets;
+    run->seed   = 1;
+    res->name   = scene->name;
+
+    if (scene->begin) {
+        ESP_RETURN_ON_ERROR(scene->begin(run), TAG, "%s: setup failed", scene->name);
+    }
+    esp_lcd_panel_ili9486_reset_stats(cfg->panel);
+    const int64_t t0 = esp_timer_get_time();
+    const int64_t until = t0 + (int64_t)cfg->scene_ms * 1000;
+    while (esp_timer_get_time() < until) {
+        scene->frame(run);
+        run->frames++;
+    }
+    // Let the last flushes reach the wire
+    int64_t t_end = esp_timer_get_time();
+    while (run->done < run->flushes && t_end - until < DRAIN_TIMEOUT_US) {
+        vTaskDelay(1);
+        t_end = esp_timer_get_time();
+    }
+    if (run->done >= run->flushes && run->flushes > 0 && run->flushes <= MAX_FLUSHES) {
+        t_end = run->done_us[run->flushes - 1];
+    }
+    if (scene->end) {
+        scene->end(run);
+    }
+    perf_summarise(run, t0, t_end, res);
+    return ESP_OK;
+}
+
+static void perf_report(const perf_config_t *cfg, const perf_result_t *res)
+{
+    printf("\nILI9486 perf bench: %s IO, pixel clock %d Hz, %d bytes/pixel\n\n",
+           cfg->io_name, cfg->pixel_clk_hz, cfg->wire_bytes_per_pixel);
+    printf("%-12s %7s %8s %9s %9s %9s %9s %8s %6s\n", "scene", "fps", "flushes",
+           "lat avg", "lat p99", "draw us", "wire us", "MB/s", "bus %");
+    for (int i = 0; i < N_SCENES; i++) {
+        const perf_result_t *r = &res[i];
+        printf("%-12s %7.1f %8lu %9.0f %9.0f %9.0f %9.0f %8.2f %6.1f\n", r->name, r->fps,
+               (unsigned long)r->flushes, r->latency_avg_us, r->latency_p99_us,
+               r->draw_avg_us, r->wire_avg_us, r->throughput_mbps,
+               r->bus_utilisation * 100.0);
+        if (r->flushes_lost) {
+            printf("  %lu flushes never completed\n", (unsigned long)r->flushes_lost);
+        }
+    }
+#if CONFIG_ILI9486_ENABLE_STATS
+    printf("\ndriver stats:\n%-12s %9s %9s %9s %7s\n", "scene", "conv cyc", "queue us",
+           "wire us", "errors");
+    for (int i = 0; i < N_SCENES; i++) {
+        const perf_result_t *r = &res[i];
+        printf("%-12s %9.2f %9.0f %9.0f %7lu\n", r->name, r->conv_cycles_per_px,
+               r->queue_avg_us, r->wire_meas_avg_us, (unsigned long)r->io_errors);
+    }
+#endif
+    printf("\n");
+
+    // Machine-readable copy, one line
+    printf("{\"bench\":\"ili9486_perf\",\"version\":1,\"io\":\"%s\",\"pixel_clk_hz\":%d,"
+           "\"wire_bytes_per_pixel\":%d,\"scene_ms\":%lu,\"scenes\":[",
+           cfg->io_name, cfg->pixel_clk_hz, cfg->wire_bytes_per_pixel,
+           (unsigned long)cfg->scene_ms);
+    for (int i = 0; i < N_SCENES; i++) {
+        const perf_result_t *r = &res[i];
+        printf("%s{\"name\":\"%s\",\"frames\":%lu,\"flushes\":%lu,\"flushes_lost\":%lu,"
+               "\"fps\":%.2f,\"latency_avg_us\":%.1f,\"latency_p99_us\":%.1f,"
+               "\"draw_avg_us\":%.1f,\"wire_avg_us\":%.1f,\"throughput_mbps\":%.3f,"
+               "\"bus_utilisation\":%.4f,\"conv_cycles_per_px\":%.3f,"
+               "\"queue_avg_us\":%.1f,\"wire_meas_avg_us\":%.1f,\"io_errors\":%lu}",
+               i ? "," : "", r->name, (unsigned long)r->frames, (unsigned long)r->flushes,
+               (unsigned long)r->flushes_lost, r->fps, r->latency_avg_us,
+               r->latency_p99_us, r->draw_avg_us, r->wire_avg_us, r->throughput_mbps,
+               r->bus_utilisation, r->conv_cycles_per_px, r->queue_avg_us,
+               r->wire_meas_avg_us, (unsigned long)r->io_errors);
+    }
+    printf("]}\n");
+}
+
+esp_err_t perf_run_scenes(const perf_config_t *cfg, perf_result_t *results)
+{
+    ESP_RETURN_ON_FALSE(cfg && cfg->panel && cfg->pixel_clk_hz > 0, ESP_ERR_INVALID_ARG,
+                        TAG, "invalid argument");
+    static perf_result_t s_results[N_SCENES];
+    perf_result_t *res = results ? results : s_results;
+    perf_assets_t assets;
+    esp_err_t ret = ESP_OK;
+
+    ESP_RETURN_ON_ERROR(perf_assets_init(&assets), TAG, "no memory for scene buffers");
+    const esp_lcd_panel_ili9486_callbacks_t cbs = {
+        .on_flush_done = perf_on_flush_done,
+    };
+    ESP_GOTO_ON_ERROR(esp_lcd_panel_ili9486_register_event_callbacks(cfg->panel, &cbs, &s_run),
+                      out, TAG, "callback registration failed");
+
+    for (int i = 0; i < N_SCENES; i++) {
+        ESP_LOGI(TAG, "scene %s, %lu ms", s_scenes[i].name, (unsigned long)cfg->scene_ms);
+        ESP_GOTO_ON_ERROR(perf_run_scene(cfg, &assets, &s_scenes[i], &res[i]), out, TAG,
+                          "scene %s failed", s_scenes[i].name);
+    }
+    perf_report(cfg, res);
+
+out:
+    perf_assets_free(&assets);
+    return ret;
+}
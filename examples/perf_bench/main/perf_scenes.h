@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    esp_lcd_panel_handle_t panel;
+    const char *io_name;            // "spi" or "mock", for the report
+    int pixel_clk_hz;               // bus clock the utilisation is measured against
+    int wire_bytes_per_pixel;       // 3 for RGB666, 2 for native RGB565
+    uint32_t scene_ms;              // how long each scene runs
+} perf_config_t;
+
+typedef struct {
+    const char *name;
+    uint32_t frames;
+    uint32_t flushes;
+    uint32_t flushes_lost;          // draws that never raised on_flush_done
+    double fps;
+    double latency_avg_us;          // draw_bitmap() call to on_flush_done
+    double latency_p99_us;
+    double draw_avg_us;             // caller blocked in draw_bitmap()
+    double wire_avg_us;             // the same flush at pixel_clk_hz
+    double throughput_mbps;         // pixel bytes per second achieved
+    double bus_utilisation;         // of pixel_clk_hz, 0..1
+    // From the driver's own instrumentation (CONFIG_ILI9486_ENABLE_STATS),
+    // zero otherwise
+    double conv_cycles_per_px;      // RGB565 -> RGB666 kernel
+    double queue_avg_us;            // draw_bitmap() to first pixel transfer
+    double wire_meas_avg_us;        // first pixel transfer to flush done
+    uint32_t io_errors;
+} perf_result_t;
+
+// Registers the driver's flush callbacks on cfg->panel, runs every scene
+// and prints a table and one JSON line. results may be NULL; otherwise it
+// holds perf_scene_count() entries.
+esp_err_t perf_run_scenes(const perf_config_t *cfg, perf_result_t *results);
+
+int perf_scene_count(void);
+
+#ifdef __cplusplus
+}
+#endif
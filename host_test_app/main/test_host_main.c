@@ -0,0 +1,20 @@
+/**
+ * test_host_main.c — ili9486 host_test_app entry point
+ *
+ * Runs the conversion kernel test cases (test/test_esp_ili9486_convert.c)
+ * once and exits with the number of failures, so CI can run the app on the
+ * linux target:
+ *   idf.py -C host_test_app --preview set-target linux
+ *   idf.py -C host_test_app build
+ *   ./host_test_app/build/ili9486_host_test_app.elf
+ */
+
+#include <stdlib.h>
+#include "unity.h"
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    unity_run_all_tests();
+    exit(UNITY_END());
+}
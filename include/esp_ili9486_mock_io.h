@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Emulated ILI9486 behind an esp_lcd panel IO (CONFIG_ILI9486_MOCK_IO).
+//
+// Pass the handle to esp_lcd_new_panel_ili9486() instead of an SPI IO.
+// The command/data stream the driver emits is decoded into a 320 x 480
+// GRAM (SWRESET, SLPIN/OUT, DISPON/OFF, INVON/OFF, COLMOD, MADCTL,
+// CASET, RASET, RAMWR, RAMWRC, VSCRDEF, VSCRSADD, NORON, TEON/OFF;
+// anything else is only counted), so tests can check pixels and count
+// bus traffic without a display. Every transfer completes immediately and
+// on_color_trans_done is called from within tx_color().
+//
+// Multi-byte parameters are accepted both as plain bytes and padded to
+// 16-bit words (flags.params_8bit either way). GRAM holds 6 bits per
+// channel as the glass of these modules shows them: in wire order with
+// BGR set in MADCTL (the driver's default), red and blue swapped with it
+// clear.
+// Only the C library is used, so the mock also builds for the linux target.
+
+typedef struct {
+    struct {
+        // Decode and count only, with no GRAM (about 460 KB otherwise),
+        // for benchmarks on targets without PSRAM
+        unsigned int no_gram : 1;
+    } flags;
+} esp_lcd_ili9486_mock_config_t;
+
+typedef struct {
+    uint32_t tx_param_calls;
+    uint32_t tx_color_calls;
+    uint32_t commands;           // command phases
+    uint64_t param_bytes;        // data bytes of other commands
+    uint64_t pixel_bytes;        // data bytes after RAMWR / RAMWRC
+    uint64_t pixels;             // whole pixels written to GRAM
+    // Malformed traffic: data with no command, parameter blocks of the
+    // wrong length, windows outside the panel
+    uint32_t protocol_errors;
+    uint32_t cmd_count[256];
+} esp_lcd_ili9486_mock_stats_t;
+
+typedef struct {
+    uint8_t madctl;
+    uint8_t colmod;
+    bool sleeping;
+    bool display_on;
+    bool inverted;
+    bool te_on;
+    bool scrolling;              // VSCRSADD received since NORON/SWRESET
+    int top_fixed;               // VSCRDEF
+    int scroll_lines;
+    int bottom_fixed;
+    int scroll_start;            // VSCRSADD
+} esp_lcd_ili9486_mock_state_t;
+
+// config may be NULL
+esp_err_t esp_lcd_new_panel_io_ili9486_mock(const esp_lcd_ili9486_mock_config_t *config,
+                                            esp_lcd_panel_io_handle_t *ret_io);
+
+// Pixel shown at physical column x (0-319), row y (0-479), with the
+// scroll area applied: 6-bit R, G, B channels.
+esp_err_t esp_lcd_ili9486_mock_get_pixel(esp_lcd_panel_io_handle_t io, int x, int y,
+                                         uint8_t rgb[3]);
+
+esp_err_t esp_lcd_ili9486_mock_get_state(esp_lcd_panel_io_handle_t io,
+                                         esp_lcd_ili9486_mock_state_t *state);
+
+esp_err_t esp_lcd_ili9486_mock_get_stats(esp_lcd_panel_io_handle_t io,
+                                         esp_lcd_ili9486_mock_stats_t *stats);
+esp_err_t esp_lcd_ili9486_mock_reset_stats(esp_lcd_panel_io_handle_t io);
+
+// Write the shown image as a binary PPM (P6, maxval 63)
+esp_err_t esp_lcd_ili9486_mock_dump_ppm(esp_lcd_panel_io_handle_t io, const char *path);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_lcd_types.h"
+#include "esp_ili9486_panel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Several ILI9486 panels.
+//
+// Every panel instance is independent: conversion buffers, window and
+// scroll state, callbacks and statistics are all per panel, so panels on
+// different buses, or on one bus with one CS line (and panel IO) each, can
+// be driven from different tasks. Two tools build on that:
+//
+// - a bus group, one converter task shared by the panels on one SPI host,
+//   which orders their flushes so the bus never idles while any panel has
+//   work queued;
+// - a span panel, one esp_lcd panel handle drawing a surface laid across
+//   several panels.
+
+// ── Bus group ────────────────────────────────────────────────────────────────
+//
+// With CONFIG_ILI9486_CONVERTER_TASK each panel normally has a converter
+// task of its own, and panels sharing a bus contend for it in whatever
+// order the tasks happen to run. A bus group replaces those tasks with one
+// (same core, priority and stack settings) that takes the regions queued
+// by draw_bitmap() on every member and flushes them one at a time, in the
+// order of the group's policy. It converts the next region, whichever
+// panel it belongs to, while the previous one is still on the wire.
+// Without CONFIG_ILI9486_CONVERTER_TASK the calls return
+// ESP_ERR_NOT_SUPPORTED.
+
+#define ILI9486_BUS_GROUP_MAX_PANELS 4
+
+typedef enum {
+    // One region from each panel with work queued, in turn
+    ILI9486_BUS_SCHED_ROUND_ROBIN = 0,
+    // Earliest deadline first: a region is due deadline_us (set per panel)
+    // after its draw_bitmap() call
+    ILI9486_BUS_SCHED_DEADLINE,
+} ili9486_bus_sched_t;
+
+typedef struct {
+    ili9486_bus_sched_t sched;
+} esp_lcd_ili9486_bus_group_config_t;
+
+typedef struct esp_lcd_ili9486_bus_group_t *esp_lcd_ili9486_bus_group_handle_t;
+
+esp_err_t esp_lcd_ili9486_bus_group_new(const esp_lcd_ili9486_bus_group_config_t *config,
+                                        esp_lcd_ili9486_bus_group_handle_t *ret_group);
+
+// Move a panel's flushes to the group task. deadline_us is only used by
+// ILI9486_BUS_SCHED_DEADLINE, e.g. the panel's frame period; a panel with
+// a smaller one is served first when both have regions of the same age.
+// Deleting the panel takes it out of the group.
+esp_err_t esp_lcd_ili9486_bus_group_add_panel(esp_lcd_ili9486_bus_group_handle_t group,
+                                              esp_lcd_panel_handle_t panel,
+                                              uint32_t deadline_us);
+
+// Give the panel its own converter task back
+esp_err_t esp_lcd_ili9486_bus_group_remove_panel(esp_lcd_ili9486_bus_group_handle_t group,
+                                                 esp_lcd_panel_handle_t panel);
+
+// Removes the panels still in the group first
+esp_err_t esp_lcd_ili9486_bus_group_del(esp_lcd_ili9486_bus_group_handle_t group);
+
+// ── Span panel ───────────────────────────────────────────────────────────────
+
+#define ILI9486_SPAN_MAX_PANELS 4
+
+typedef enum {
+    // Side by side, panels[0] on the left: two 320 x 480 panels make a
+    // 640 x 480 surface
+    ILI9486_SPAN_HORIZONTAL = 0,
+    // Stacked, panels[0] on top: two 320 x 480 panels make 320 x 960
+    ILI9486_SPAN_VERTICAL,
+} ili9486_span_layout_t;
+
+typedef struct {
+    esp_lcd_panel_handle_t panels[ILI9486_SPAN_MAX_PANELS];    // ILI9486 panels
+    int panel_count;
+    ili9486_span_layout_t layout;
+} esp_lcd_ili9486_span_config_t;
+
+// Panel handle for one surface across several ILI9486 panels of the same
+// size and pixel format. Orient the panels (swap_xy, mirror) before
+// creating the span.
+//
+// draw_bitmap() is split at the panel edges and each piece is drawn on its
+// panel straight from the caller's buffer. A horizontal span reads pieces
+// with a row pitch, so in the zero-copy modes each of their rows is a
+// DMA transfer of its own. reset, init, invert_color and disp_on_off go to
+// every panel; mirror, swap_xy and set_gap return ESP_ERR_NOT_SUPPORTED.
+// Frames (begin_frame / end_frame) are per panel and not used by the
+// span. Deleting the span leaves the panels as they are.
+esp_err_t esp_lcd_new_panel_ili9486_span(const esp_lcd_ili9486_span_config_t *config,
+                                         esp_lcd_panel_handle_t *ret_panel);
+
+// on_src_released fires once per span draw_bitmap(), when every panel the
+// draw touched has released its piece. on_flush_done is not supported
+// (ESP_ERR_NOT_SUPPORTED): a panel that ends up sending nothing for its
+// piece raises none. This registers callbacks on the panels, replacing
+// any registered there.
+esp_err_t esp_lcd_panel_ili9486_span_register_event_callbacks(
+    esp_lcd_panel_handle_t span,
+    const esp_lcd_panel_ili9486_callbacks_t *cbs,
+    void *user_ctx);
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,6 +6,329 @@
 #include "esp_lcd_panel_ops.h"        // ← esp_lcd_panel_handle_t
 #include "esp_lcd_panel_vendor.h"     // ← esp_lcd_panel_dev_config_t  ✓
 
+// Interface pixel format for RGB565 input (bits_per_pixel 16).
+//
+// With esp_lcd_panel_dev_config_t.bits_per_pixel = 24 draw_bitmap() takes
+// RGB888 instead, stored B, G, R like LVGL's LV_COLOR_FORMAT_RGB888. The
+// driver clears the BGR bit of MADCTL so the panel reads that order as is,
+// and the buffer is sent zero-copy under the same rules as
+// ILI9486_PIXEL_FORMAT_RGB565 below. 18 is not accepted.
+typedef enum {
+    // COLMOD 0x66: pixels are converted to RGB666 (3 bytes) by the driver.
+    // The only format a plain 4-wire SPI ILI9486 accepts.
+    ILI9486_PIXEL_FORMAT_RGB666 = 0,
+    // COLMOD 0x55: color_data is sent as is, with no conversion and no
+    // copy. For modules with a 16-bit parallel front end behind a shift
+    // register (e.g. the RPi 3.5" boards). color_data must be big-endian
+    // RGB565 in DMA-capable memory and stays in use until on_flush_done.
+    ILI9486_PIXEL_FORMAT_RGB565,
+} ili9486_pixel_format_t;
+
+// How flushes are scheduled against the panel refresh (flags.te_enable).
+typedef enum {
+    // Start a flush only shortly after a TE pulse, while the scan is still
+    // at the top of the frame. Simple, but a flush may wait up to a frame.
+    ILI9486_TE_MODE_VBLANK = 0,
+    // Start a flush as soon as the line being scanned, estimated from the
+    // TE pulse and the measured frame period, lies outside its rows and
+    // the write, timed from the bus rate of earlier flushes, can finish
+    // ahead of the scan or behind it. Otherwise the flush waits as in
+    // VBLANK mode. The bus is timed with the flush-done event, so until
+    // callbacks are registered every flush waits for VBLANK.
+    ILI9486_TE_MODE_BEAM_CHASE,
+} ili9486_te_mode_t;
+
+// One step of the panel init sequence: a command, its parameters (one
+// byte each, sent in the module's parameter width like every other
+// command) and the time the panel needs before the next command. Keep
+// tables and parameters const so they stay in flash.
+typedef struct {
+    uint8_t cmd;
+    uint8_t data_bytes;
+    uint16_t delay_ms;
+    const uint8_t *data;
+} ili9486_lcd_init_cmd_t;
+
+// Optional vendor config, passed via esp_lcd_panel_dev_config_t.vendor_config.
+// Leave vendor_config NULL (or fields zero) for the defaults.
+typedef struct {
+    ili9486_pixel_format_t pixel_format;
+    // Capacity of each RGB666 conversion buffer, in pixels (3 bytes each).
+    // 0 = default: 320 x 80 rows, or CONFIG_ILI9486_PIPELINE_CHUNK_PIXELS
+    // per ping-pong chunk when the pipelined flush is enabled.
+    size_t conv_buf_pixels;
+    // Tearing-effect output of the panel, used with flags.te_enable
+    int te_gpio_num;
+    ili9486_te_mode_t te_mode;
+    // Init sequence replacing the driver's (SWRESET, SLPOUT and the power,
+    // timing and gamma registers of the RPi 3.5" modules). COLMOD, MADCTL,
+    // TEON and DISPON still follow it from the panel state. A SWRESET in
+    // the table is skipped right after a hardware reset, its delay counted
+    // from the end of the reset pulse.
+    const ili9486_lcd_init_cmd_t *init_cmds;
+    uint16_t init_cmds_size;
+    // Boot splash written into GRAM by init, before DISPON, so the panel
+    // shows it instead of stale GRAM as soon as it is switched on. The
+    // image is centred (cropped if larger) on the background colour and
+    // decoded from splash a few rows at a time, with no frame buffer;
+    // splash must stay readable until init is done, e.g. an EMBED_FILES
+    // blob or an esp_partition_mmap() mapping. Make it with
+    // tools/splash_encode.py. Format, integers little-endian:
+    //   "ISPL", u8 version (1), u8 flags (bit 0: palette),
+    //   u16 width, u16 height, u16 background (RGB565),
+    //   u16 palette size n (0 without palette), n x u16 RGB565 colours,
+    //   then packets until the image is complete: a byte h and
+    //   h & 0x80 ? one value repeated (h & 0x7F) + 1 times
+    //            : h + 1 values,
+    //   a value being a palette index byte or a u16 RGB565 colour.
+    const void *splash;
+    size_t splash_size;
+    struct {
+        // Allocate the conversion buffers from PSRAM instead of internal
+        // RAM. Only honoured on targets whose DMA can reach PSRAM (ESP32-S3).
+        unsigned int conv_buf_in_psram : 1;
+        // Send multi-byte command parameters (CASET/RASET) as plain bytes,
+        // for modules on a true 8-bit SPI interface. By default each byte
+        // is padded to a 16-bit word, as the RPi-style boards with a
+        // 16-bit shift-register front end need.
+        unsigned int params_8bit : 1;
+        // Enable TEON and hold each flush until it cannot tear (te_mode).
+        // Installs the GPIO ISR service if the application has not.
+        unsigned int te_enable : 1;
+        // Keep a shadow of GRAM with a hash per 16 x 16 tile and send only
+        // the tiles of a draw_bitmap() whose pixels changed. The shadow
+        // pixels go to PSRAM; without it only hashes are kept and tiles a
+        // draw covers partly are always sent.
+        unsigned int shadow_fb : 1;
+        // Make set_orientation() rotate in software: MADCTL stays at
+        // ILI9486_ORIENTATION_0 and draw_bitmap() reads each area rotated
+        // and converts it into panel order in the same pass, so GRAM is
+        // always written along the scan, as TE sync assumes. Needs
+        // RGB666 with 16 bpp input. While rotated, fill_rect() is mapped
+        // too, but draw_indexed() and begin_frame() are refused
+        // (ESP_ERR_INVALID_STATE). Do not mix with mirror()/swap_xy().
+        unsigned int sw_orientation : 1;
+    } flags;
+    // Dirty-rectangle coalescing (begin_frame / end_frame). Costs are in
+    // bytes of bus time; 0 = default for each field.
+    struct {
+        uint8_t max_rects;      // rectangles held per frame (16, at most 32)
+        uint16_t setup_bytes;   // one CASET/RASET/RAMWR window setup (128)
+        // Each extra contiguous source run in a merged window: 32 in the
+        // zero-copy modes (one more DMA transfer), 4 otherwise
+        uint16_t span_bytes;
+    } coalesce;
+} ili9486_vendor_config_t;
+
 esp_err_t esp_lcd_new_panel_ili9486(esp_lcd_panel_io_handle_t io,
                                     const esp_lcd_panel_dev_config_t *panel_dev_config,
-                                    esp_lcd_panel_handle_t *ret_panel);
\ No newline at end of file
+                                    esp_lcd_panel_handle_t *ret_panel);
+
+// Non-blocking panel init.
+//
+// esp_lcd_panel_init() waits out the delays of the init sequence, about
+// 125 ms in all, mostly the 120 ms the panel needs between a reset and
+// SLPOUT. init_begin() starts the sequence instead and init_poll() sends
+// whatever has come due, so the delays overlap other boot work. Until it
+// returns ESP_OK, no other call may be made on the panel.
+esp_err_t esp_lcd_panel_ili9486_init_begin(esp_lcd_panel_handle_t panel);
+// Returns ESP_ERR_NOT_FINISHED while steps remain, with the time until
+// the next one in *wait_us (may be NULL); ESP_OK once the panel is
+// initialised, or when no init is in progress.
+esp_err_t esp_lcd_panel_ili9486_init_poll(esp_lcd_panel_handle_t panel, uint32_t *wait_us);
+
+// Display orientation. Each step turns the image a further 90 degrees,
+// in the same sense as LVGL's lv_display_rotation_t, so LV_DISPLAY_ROTATION_n
+// maps to ILI9486_ORIENTATION_n.
+typedef enum {
+    ILI9486_ORIENTATION_0,      // portrait, 320 x 480
+    ILI9486_ORIENTATION_90,     // landscape, 480 x 320
+    ILI9486_ORIENTATION_180,    // portrait, upside down
+    ILI9486_ORIENTATION_270,    // landscape, upside down
+} ili9486_orientation_t;
+
+// Rotate in hardware: sets the MX/MY/MV bits of MADCTL in one write,
+// keeping BGR, so draw_bitmap() takes coordinates in the rotated screen
+// and no software rotation is needed. Width and height swap with the
+// orientation, and so do the gaps from set_gap() (as with swap_xy()); the
+// cached window and shadow tiles are dropped. Supersedes mirror() and
+// swap_xy(), which only flip single bits. Only ILI9486_ORIENTATION_0 is
+// allowed while a scroll area is defined (ESP_ERR_INVALID_STATE
+// otherwise). With flags.sw_orientation draw_bitmap() rotates instead,
+// MADCTL and the gaps are left alone, and only ILI9486_ORIENTATION_0 is
+// allowed while a frame is open either.
+esp_err_t esp_lcd_panel_ili9486_set_orientation(esp_lcd_panel_handle_t panel,
+                                                ili9486_orientation_t orientation);
+
+// Fill [x_start, x_end) x [y_start, y_end) with one RGB565 colour, in the
+// same coordinates as draw_bitmap(). The window is set once and a small
+// pre-converted pattern is queued to the SPI DMA repeatedly, with no
+// per-pixel CPU work. Returns once the transfers are queued; no flush
+// callbacks are raised.
+esp_err_t esp_lcd_panel_ili9486_fill_rect(esp_lcd_panel_handle_t panel,
+                                          int x_start, int y_start,
+                                          int x_end, int y_end,
+                                          uint16_t color);
+
+// Palette for esp_lcd_panel_ili9486_draw_indexed(), converted once to the
+// wire format of the panel it was made for. Fill it with palette_init();
+// the fields are the driver's. One palette serves any panel with the
+// same pixel format.
+typedef struct {
+    uint32_t entries[256];      // wire bytes of each entry, first byte lowest
+    uint8_t bytes_per_pixel;    // 3 (RGB666) or 2 (native RGB565)
+} ili9486_palette_t;
+
+// Convert count (1..256) RGB565 colours, in CPU byte order like
+// fill_rect(). Entries from count on are black.
+esp_err_t esp_lcd_panel_ili9486_palette_init(esp_lcd_panel_handle_t panel,
+                                             const uint16_t *colors, size_t count,
+                                             ili9486_palette_t *palette);
+
+// Draw a palette-indexed bitmap into [x_start, x_end) x [y_start, y_end),
+// in the same coordinates as draw_bitmap(). bits_per_index is 1, 2, 4 or
+// 8; indices are packed MSB first and each row starts on a byte, as in
+// LVGL's I1/I2/I4/I8 image data (without its palette). Each index is
+// looked up straight into wire format, with no RGB565 step, into a small
+// DMA buffer of the driver's; indices can stay in flash. Like fill_rect(),
+// returns once the last chunk is queued and raises no flush callbacks.
+esp_err_t esp_lcd_panel_ili9486_draw_indexed(esp_lcd_panel_handle_t panel,
+                                             int x_start, int y_start,
+                                             int x_end, int y_end,
+                                             const void *indices, int bits_per_index,
+                                             const ili9486_palette_t *palette);
+
+// Hardware vertical scrolling.
+//
+// Define top_fixed rows at the top and bottom_fixed rows at the bottom
+// that stay put; the rows in between form the scroll area. The scroll
+// offset starts at 0. Needs the default row order: returns
+// ESP_ERR_INVALID_STATE with swap_xy or mirror_y applied (any orientation
+// but ILI9486_ORIENTATION_0), and those are refused while a scroll area
+// is defined (until the next reset/init).
+esp_err_t esp_lcd_panel_ili9486_scroll_define(esp_lcd_panel_handle_t panel,
+                                              int top_fixed, int bottom_fixed);
+
+// Scroll the content of the scroll area up by offset rows
+// (0 <= offset < scroll area height). Only VSCRSADD is sent; nothing is
+// redrawn. draw_bitmap() and fill_rect() keep taking logical screen
+// coordinates and are remapped to GRAM, so after scroll_to(n) a newly
+// exposed bottom row is drawn at its on-screen position.
+esp_err_t esp_lcd_panel_ili9486_scroll_to(esp_lcd_panel_handle_t panel, int offset);
+
+// Leave scroll mode (NORON). GRAM is shown unscrolled again and draws are
+// no longer remapped; redraw whatever the offset had moved.
+esp_err_t esp_lcd_panel_ili9486_scroll_stop(esp_lcd_panel_handle_t panel);
+
+// Dirty-rectangle coalescing.
+//
+// Between begin_frame() and end_frame(), draw_bitmap() only records the
+// rectangle. end_frame() merges overlapping or adjacent rectangles when
+// one window costs less bus time than several (see vendor coalesce), and
+// sends the resulting windows. A merged window is written from the
+// callers' buffers only, so rectangles are merged only when together they
+// cover its whole bounding box; where they overlap, the later one wins.
+//
+// Every color_data must stay valid until the frame is released: the
+// flush callbacks fire once for the whole frame instead of per
+// draw_bitmap(). If more than max_rects rectangles are drawn, those held
+// so far are sent early. fill_rect(), scrolling, mirror, swap_xy,
+// set_gap and set_orientation also send the held rectangles first.
+esp_err_t esp_lcd_panel_ili9486_begin_frame(esp_lcd_panel_handle_t panel);
+esp_err_t esp_lcd_panel_ili9486_end_frame(esp_lcd_panel_handle_t panel);
+
+// Driver event callback. Returns true if a higher priority task was woken
+// (only meaningful when called from ISR context).
+typedef bool (*esp_lcd_panel_ili9486_event_cb_t)(esp_lcd_panel_handle_t panel,
+                                                 void *user_ctx);
+
+typedef struct {
+    // The color_data passed to draw_bitmap() has been fully consumed and
+    // may be reused. Called from the converting task (the draw_bitmap()
+    // caller, or the converter task) as soon as the last pixel is
+    // converted, while the tail of the flush is still on the wire.
+    // In the zero-copy modes (ILI9486_PIXEL_FORMAT_RGB565, RGB888 input)
+    // the buffer is read by DMA, so it is called from ISR context right
+    // before on_flush_done.
+    esp_lcd_panel_ili9486_event_cb_t on_src_released;
+    // The last pixel of the flush has been shifted out. ISR context. A
+    // flush that sends nothing (the shadow framebuffer found its area
+    // unchanged, or an empty frame) still gets it, from the flushing task
+    // once earlier flushes are off the wire.
+    esp_lcd_panel_ili9486_event_cb_t on_flush_done;
+} esp_lcd_panel_ili9486_callbacks_t;
+
+// Register asynchronous flush callbacks.
+//
+// This takes over the panel IO's on_color_trans_done (the driver needs it
+// to tell the end of a flush apart from its window-setup transfers), so
+// call it after anything else that registers IO callbacks, e.g.
+// lvgl_port_add_disp(). Without it, draw_bitmap() keeps the plain esp_lcd
+// behaviour and the IO callbacks are left to their owner.
+esp_err_t esp_lcd_panel_ili9486_register_event_callbacks(
+    esp_lcd_panel_handle_t panel,
+    const esp_lcd_panel_ili9486_callbacks_t *cbs,
+    void *user_ctx);
+
+// Buckets of stats.flush_size_hist
+#define ILI9486_FLUSH_HIST_BUCKETS 8
+
+typedef struct {
+    // Converter task ring (CONFIG_ILI9486_CONVERTER_TASK), zero otherwise
+    uint32_t queue_depth;        // ring capacity in regions
+    uint32_t queue_used;         // regions waiting or being converted now
+    uint32_t queue_high_water;   // largest queue_used seen
+    uint32_t queue_full_stalls;  // draw_bitmap() calls that waited for space
+    uint32_t regions_submitted;  // draw_bitmap() calls handed to the task
+    // CASET/RASET commands left out because the window was unchanged
+    uint32_t window_cmds_skipped;
+    // TE scheduling (flags.te_enable), zero otherwise
+    uint32_t te_frames;              // TE pulses seen
+    uint32_t te_frame_period_us;     // measured refresh period
+    uint32_t te_waits;               // flushes that were held back
+    uint32_t te_timeouts;            // waits that gave up on a missing pulse
+    uint32_t te_chase_fallbacks;     // beam-chase flushes held for VBLANK instead
+    uint32_t te_wait_us_max;         // longest single hold
+    uint32_t te_wait_us_last_frame;  // total hold during the previous frame
+    uint64_t te_wait_us_total;
+    // Coalescing: rectangles drawn inside frames, windows actually sent,
+    // and the bus bytes saved by merging per the cost model
+    uint32_t coalesce_rects_in;
+    uint32_t coalesce_rects_out;
+    uint64_t coalesce_bytes_saved;
+    // Shadow framebuffer (flags.shadow_fb): tile pieces of draws compared,
+    // those found unchanged and the pixel bytes not sent for them
+    uint32_t shadow_tiles_checked;
+    uint32_t shadow_tiles_unchanged;
+    uint64_t shadow_bytes_skipped;
+    // Flush instrumentation (CONFIG_ILI9486_ENABLE_STATS), zero otherwise.
+    // A flush is one draw_bitmap() call, or one end_frame().
+    uint32_t flushes;
+    uint32_t errors;             // panel IO calls that failed
+    uint64_t pixels;             // written to GRAM, fill_rect() included
+    uint64_t bytes_sent;         // commands, parameters and pixel data
+    uint32_t commands_sent;
+    uint64_t conv_pixels;        // put through the RGB565 -> RGB666 kernel
+    uint64_t conv_cycles;        // CPU cycles spent in it
+    // Call to first pixel transfer queued: converter ring, TE hold, wait
+    // for the previous flush and the first chunk's conversion
+    uint64_t queue_us_total;
+    uint32_t queue_us_max;
+    // First pixel transfer queued to the last one done. Needs the done
+    // event, so only counted with registered callbacks; wire_flushes is
+    // the number of flushes timed.
+    uint64_t wire_us_total;
+    uint32_t wire_us_max;
+    uint32_t wire_flushes;
+    // Flush sizes (CONFIG_ILI9486_STATS_HISTOGRAM): bucket i counts
+    // flushes of fewer than 64 << 2i pixels, the last one all larger ones
+    uint32_t flush_size_hist[ILI9486_FLUSH_HIST_BUCKETS];
+} esp_lcd_panel_ili9486_stats_t;
+
+// Snapshot the driver counters.
+esp_err_t esp_lcd_panel_ili9486_get_stats(esp_lcd_panel_handle_t panel,
+                                          esp_lcd_panel_ili9486_stats_t *stats);
+
+// Zero the counters, maxima and the histogram. Current state (queue
+// depth and use, TE frame period) is kept.
+esp_err_t esp_lcd_panel_ili9486_reset_stats(esp_lcd_panel_handle_t panel);
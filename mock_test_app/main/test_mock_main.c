@@ -0,0 +1,18 @@
+/**
+ * test_mock_main.c — ili9486 mock_test_app entry point
+ *
+ * Runs the test cases that use the emulated panel IO
+ * (esp_lcd_new_panel_io_ili9486_mock()) once. Nothing is initialised and
+ * nothing needs to be wired, so any board, or QEMU, will do:
+ *   idf.py -C mock_test_app set-target esp32s3
+ *   idf.py -C mock_test_app build flash monitor
+ */
+
+#include "unity.h"
+
+void app_main(void)
+{
+    UNITY_BEGIN();
+    unity_run_all_tests();
+    UNITY_END();
+}
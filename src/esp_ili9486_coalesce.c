@@ -0,0 +1,195 @@
+// ─── esp_ili9486_coalesce.c ─────────────────────────────────────────────────
+// Dirty-rectangle coalescing for begin_frame() / end_frame(). The frame's
+// rectangles are merged greedily into groups whose bounding box is fully
+// covered by their members: the caller's buffers are the only pixels the
+// driver has, so a merged window must be written entirely from them.
+// Where members overlap, the one drawn last wins, as it would have done
+// on the panel.
+#include <string.h>
+#include <sys/param.h>
+#include "esp_ili9486_priv.h"
+
+static bool ili9486_overlap(const ili9486_rect_group_t *a, int x_start, int y_start,
+                            int x_end, int y_end)
+{
+    return a->x_start < x_end && x_start < a->x_end &&
+           a->y_start < y_end && y_start < a->y_end;
+}
+
+static bool ili9486_covers(const ili9486_region_t *r, int x, int y)
+{
+    return x >= r->x_start && x < r->x_end && y >= r->y_start && y < r->y_end;
+}
+
+int ili9486_coalesce_row(const ili9486_coalesce_t *c, uint32_t members,
+                         int x_start, int x_end, int y, ili9486_span_t *spans)
+{
+    int n = 0;
+    for (int x = x_start; x < x_end; n++) {
+        int rect = -1;
+        for (int i = c->count - 1; i >= 0; i--) {
+            if ((members & (1u << i)) && ili9486_covers(&c->rects[i], x, y)) {
+                rect = i;
+                break;
+            }
+        }
+        if (rect < 0) {
+            return -1;
+        }
+        // Runs to the member's right edge, or to where a later member
+        // on this row takes over
+        int end = c->rects[rect].x_end;
+        for (int i = rect + 1; i < c->count; i++) {
+            const ili9486_region_t *r = &c->rects[i];
+            if ((members & (1u << i)) && y >= r->y_start && y < r->y_end &&
+                r->x_start > x && r->x_start < end) {
+                end = r->x_start;
+            }
+        }
+        spans[n] = (ili9486_span_t){ .rect = rect, .x_start = x, .x_end = end };
+        x = end;
+    }
+    return n;
+}
+
+// Cost of writing the members as one window with the given bounding box:
+// one setup, the pixels, and one span per contiguous source run. Returns
+// -1 if the box is not covered.
+//
+// Rows between consecutive member edges share a layout, so one row per
+// band is evaluated. A row's last span continues straight into the next
+// row's first one when both come from a member as wide as the window.
+static int32_t ili9486_group_cost(ili9486_coalesce_t *c, uint32_t members,
+                                  int x_start, int y_start, int x_end, int y_end)
+{
+    int edges[2 * COALESCE_MAX_RECTS + 2];
+    int n_edges = 0;
+    edges[n_edges++] = y_start;
+    edges[n_edges++] = y_end;
+    for (int i = 0; i < c->count; i++) {
+        if (members & (1u << i)) {
+            edges[n_edges++] = c->rects[i].y_start;
+            edges[n_edges++] = c->rects[i].y_end;
+        }
+    }
+    // Insertion sort, few entries
+    for (int i = 1; i < n_edges; i++) {
+        int v = edges[i], j = i;
+        for (; j > 0 && edges[j - 1] > v; j--) {
+            edges[j] = edges[j - 1];
+        }
+        edges[j] = v;
+    }
+
+    int32_t spans = 0;
+    int prev_last = -1;
+    for (int i = 0; i + 1 < n_edges; i++) {
+        int ya = edges[i], yb = edges[i + 1];
+        if (ya == yb || ya < y_start || yb > y_end) {
+            continue;
+        }
+        int k = ili9486_coalesce_row(c, members, x_start, x_end, ya, c->spans);
+        if (k < 0) {
+            return -1;
+        }
+        int first = c->spans[0].rect;
+        int last  = c->spans[k - 1].rect;
+        bool full = c->rects[first].x_start == x_start && c->rects[first].x_end == x_end;
+        int rows  = yb - ya;
+        spans += k * rows;
+        if (first == last && full) {
+            spans -= rows - 1;
+        }
+        if (prev_last == first && full) {
+            spans--;
+        }
+        prev_last = last;
+    }
+
+    int32_t pixels = (x_end - x_start) * (y_end - y_start);
+    return c->setup_bytes + pixels * c->wire_bytes_per_pixel + spans * c->span_bytes;
+}
+
+int ili9486_coalesce_plan(ili9486_coalesce_t *c)
+{
+    ili9486_rect_group_t *g = c->groups;
+    int n = c->count;
+    int64_t separate = 0;
+
+    for (int i = 0; i < n; i++) {
+        const ili9486_region_t *r = &c->rects[i];
+        g[i] = (ili9486_rect_group_t){
+            .members = 1u << i,
+            .x_start = r->x_start,
+            .y_start = r->y_start,
+            .x_end   = r->x_end,
+            .y_end   = r->y_end,
+        };
+        g[i].cost = ili9486_group_cost(c, g[i].members, r->x_start, r->y_start,
+                                       r->x_end, r->y_end);
+        separate += g[i].cost;
+    }
+
+    // Merge the pair that saves most until no merge saves anything. A
+    // merged box must not touch any other group, so groups that overlap
+    // are all single rectangles and are emitted in drawing order; since
+    // j is always folded into i < j, groups stay sorted by first member.
+    for (;;) {
+        int32_t best_gain = 0;
+        int bi = -1, bj = -1;
+        ili9486_rect_group_t best = {0};
+
+        for (int i = 0; i < n; i++) {
+            for (int j = i + 1; j < n; j++) {
+                ili9486_rect_group_t m = {
+                    .members = g[i].members | g[j].members,
+                    .x_start = MIN(g[i].x_start, g[j].x_start),
+                    .y_start = MIN(g[i].y_start, g[j].y_start),
+                    .x_end   = MAX(g[i].x_end, g[j].x_end),
+                    .y_end   = MAX(g[i].y_end, g[j].y_end),
+                };
+                // Cheap rejection: the box cannot be covered if it is
+                // larger than both groups together
+                int32_t area   = (m.x_end - m.x_start) * (m.y_end - m.y_start);
+                int32_t area_i = (g[i].x_end - g[i].x_start) * (g[i].y_end - g[i].y_start);
+                int32_t area_j = (g[j].x_end - g[j].x_start) * (g[j].y_end - g[j].y_start);
+                if (area > area_i + area_j) {
+                    continue;
+                }
+                bool clear = true;
+                for (int k = 0; k < n && clear; k++) {
+                    clear = k == i || k == j ||
+                            !ili9486_overlap(&g[k], m.x_start, m.y_start, m.x_end, m.y_end);
+                }
+                if (!clear) {
+                    continue;
+                }
+                m.cost = ili9486_group_cost(c, m.members, m.x_start, m.y_start,
+                                            m.x_end, m.y_end);
+                if (m.cost < 0) {
+                    continue;
+                }
+                int32_t gain = g[i].cost + g[j].cost - m.cost;
+                if (gain > best_gain) {
+                    best_gain = gain;
+                    best = m;
+                    bi = i;
+                    bj = j;
+                }
+            }
+        }
+        if (bi < 0) {
+            break;
+        }
+        g[bi] = best;
+        memmove(&g[bj], &g[bj + 1], (n - bj - 1) * sizeof(g[0]));
+        n--;
+    }
+
+    int64_t merged = 0;
+    for (int i = 0; i < n; i++) {
+        merged += g[i].cost;
+    }
+    c->bytes_saved += separate - merged;
+    return n;
+}
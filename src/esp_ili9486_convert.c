@@ -0,0 +1,366 @@
+// ─── esp_ili9486_convert.c ──────────────────────────────────────────────────
+#include <stdbool.h>
+#include <stdatomic.h>
+#include "sdkconfig.h"
+#include "esp_ili9486_convert.h"
+
+// R, G, B bytes of one pixel packed little-endian into the low 24 bits
+static inline uint32_t rgb666_pack(uint16_t p)
+{
+    return (((p >> 11) & 0x1F) << 3)
+         | (((p >> 5)  & 0x3F) << 2) << 8
+         | (( p        & 0x1F) << 3) << 16;
+}
+
+static inline void rgb666_store(uint8_t *dst, uint32_t v)
+{
+    dst[0] = (uint8_t)v;
+    dst[1] = (uint8_t)(v >> 8);
+    dst[2] = (uint8_t)(v >> 16);
+}
+
+// Number of leading pixels after which dst + 3 * n is word aligned
+static inline size_t head_pixels(const uint8_t *dst)
+{
+    return ((4 - ((uintptr_t)dst & 3)) * 3) & 3;
+}
+
+// Source pixels at an odd address. 16-bit loads from there fault on
+// Xtensa, so each pixel is put together from its two (little-endian) bytes.
+static inline uint16_t rgb565_load_bytes(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static void rgb565_to_rgb666_bytes(const uint8_t *src, uint8_t *dst, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++) {
+        rgb666_store(dst, rgb666_pack(rgb565_load_bytes(src)));
+        src += 2;
+        dst += 3;
+    }
+}
+
+static inline bool src_misaligned(const uint16_t *src)
+{
+    return (uintptr_t)src & 1;
+}
+
+void ili9486_rgb565_to_rgb666_ref(const uint16_t *src, uint8_t *dst, size_t pixels)
+{
+    if (src_misaligned(src)) {
+        rgb565_to_rgb666_bytes((const uint8_t *)src, dst, pixels);
+        return;
+    }
+    for (size_t i = 0; i < pixels; i++) {
+        uint16_t p = src[i];
+        dst[3*i + 0] = ((p >> 11) & 0x1F) << 3;
+        dst[3*i + 1] = ((p >> 5)  & 0x3F) << 2;
+        dst[3*i + 2] = ( p        & 0x1F) << 3;
+    }
+}
+
+// Pixels a b c d (24 bits each) as three little-endian words:
+//   w0 = a0 a1 a2 b0   w1 = b1 b2 c0 c1   w2 = c2 d0 d1 d2
+#define STORE_4PX(out, a, b, c, d) do {          \
+        (out)[0] = (a)         | ((b) << 24);   \
+        (out)[1] = ((b) >> 8)  | ((c) << 16);   \
+        (out)[2] = ((c) >> 16) | ((d) << 8);    \
+    } while (0)
+
+void ili9486_rgb565_to_rgb666_word(const uint16_t *src, uint8_t *dst, size_t pixels)
+{
+    if (src_misaligned(src)) {
+        rgb565_to_rgb666_bytes((const uint8_t *)src, dst, pixels);
+        return;
+    }
+
+    size_t head = head_pixels(dst);
+    if (head > pixels) {
+        head = pixels;
+    }
+    for (size_t i = 0; i < head; i++) {
+        rgb666_store(dst, rgb666_pack(*src++));
+        dst += 3;
+    }
+    pixels -= head;
+
+    uint32_t *out = (uint32_t *)(void *)dst;
+    for (size_t n = pixels >> 2; n > 0; n--) {
+        STORE_4PX(out, rgb666_pack(src[0]), rgb666_pack(src[1]),
+                       rgb666_pack(src[2]), rgb666_pack(src[3]));
+        src += 4;
+        out += 3;
+    }
+
+    dst = (uint8_t *)out;
+    for (size_t i = 0; i < (pixels & 3); i++) {
+        rgb666_store(dst, rgb666_pack(*src++));
+        dst += 3;
+    }
+}
+
+// s_lut_hi[p >> 8] | s_lut_lo[p & 0xFF] == rgb666_pack(p). Shared by
+// every panel; converter tasks of two panels may build them at the same
+// time, which is harmless as both write the same values, but neither may
+// use them before its own stores or the other's are visible.
+static uint32_t s_lut_hi[256];
+static uint32_t s_lut_lo[256];
+static atomic_bool s_lut_ready;
+
+static void lut_init(void)
+{
+    if (atomic_load_explicit(&s_lut_ready, memory_order_acquire)) {
+        return;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        s_lut_hi[i] = rgb666_pack((uint16_t)(i << 8));
+        s_lut_lo[i] = rgb666_pack((uint16_t)i);
+    }
+    atomic_store_explicit(&s_lut_ready, true, memory_order_release);
+}
+
+static inline uint32_t lut_pack(uint16_t p)
+{
+    return s_lut_hi[p >> 8] | s_lut_lo[p & 0xFF];
+}
+
+void ili9486_rgb565_to_rgb666_lut(const uint16_t *src, uint8_t *dst, size_t pixels)
+{
+    lut_init();
+    if (src_misaligned(src)) {
+        rgb565_to_rgb666_bytes((const uint8_t *)src, dst, pixels);
+        return;
+    }
+
+    size_t head = head_pixels(dst);
+    if (head > pixels) {
+        head = pixels;
+    }
+    for (size_t i = 0; i < head; i++) {
+        rgb666_store(dst, lut_pack(*src++));
+        dst += 3;
+    }
+    pixels -= head;
+
+    uint32_t *out = (uint32_t *)(void *)dst;
+    for (size_t n = pixels >> 2; n > 0; n--) {
+        STORE_4PX(out, lut_pack(src[0]), lut_pack(src[1]),
+                       lut_pack(src[2]), lut_pack(src[3]));
+        src += 4;
+        out += 3;
+    }
+
+    dst = (uint8_t *)out;
+    for (size_t i = 0; i < (pixels & 3); i++) {
+        rgb666_store(dst, lut_pack(*src++));
+        dst += 3;
+    }
+}
+
+// Output pixels per tile edge of a transposed conversion. 16 RGB565
+// source pixels fill one 32-byte cache line, so a tile reads 16 lines
+// and writes 16 runs of 48 bytes.
+#define XFORM_TILE 16
+
+// One output run of pixels, read from src[pos], src[pos + step], ...
+// Indices rather than pointers, as a backward walk ends before src.
+static void xform_run(const uint16_t *src, ptrdiff_t pos, ptrdiff_t step,
+                      uint8_t *dst, size_t pixels)
+{
+    if (src_misaligned(src)) {
+        const uint8_t *bytes = (const uint8_t *)src;
+        for (size_t i = 0; i < pixels; i++) {
+            rgb666_store(dst, rgb666_pack(rgb565_load_bytes(bytes + 2 * pos)));
+            pos += step;
+            dst += 3;
+        }
+        return;
+    }
+
+    size_t head = head_pixels(dst);
+    if (head > pixels) {
+        head = pixels;
+    }
+    for (size_t i = 0; i < head; i++) {
+        rgb666_store(dst, rgb666_pack(src[pos]));
+        pos += step;
+        dst += 3;
+    }
+    pixels -= head;
+
+    uint32_t *out = (uint32_t *)(void *)dst;
+    for (size_t n = pixels >> 2; n > 0; n--) {
+        STORE_4PX(out, rgb666_pack(src[pos]),            rgb666_pack(src[pos + step]),
+                       rgb666_pack(src[pos + 2 * step]), rgb666_pack(src[pos + 3 * step]));
+        pos += 4 * step;
+        out += 3;
+    }
+
+    dst = (uint8_t *)out;
+    for (size_t i = 0; i < (pixels & 3); i++) {
+        rgb666_store(dst, rgb666_pack(src[pos]));
+        pos += step;
+        dst += 3;
+    }
+}
+
+void ili9486_rgb565_to_rgb666_xform(const uint16_t *src, size_t stride,
+                                    int width, int height, ili9486_xform_t xform,
+                                    int row, int rows, uint8_t *dst)
+{
+    const bool swap = xform & ILI9486_XFORM_SWAP_XY;
+    const int out_w = swap ? height : width;
+    const int out_h = swap ? width : height;
+
+    // Steps in the source along an output row and down an output column,
+    // and the source index of output pixel (0, 0)
+    const ptrdiff_t dx = (xform & ILI9486_XFORM_MIRROR_X) ? -1 : 1;
+    const ptrdiff_t dy = (xform & ILI9486_XFORM_MIRROR_Y) ? -1 : 1;
+    const ptrdiff_t ux = dx < 0 ? out_w - 1 : 0;
+    const ptrdiff_t uy = dy < 0 ? out_h - 1 : 0;
+    const ptrdiff_t step_x = swap ? dx * (ptrdiff_t)stride : dx;
+    const ptrdiff_t step_y = swap ? dy : dy * (ptrdiff_t)stride;
+    const ptrdiff_t origin = swap ? ux * (ptrdiff_t)stride + uy : uy * (ptrdiff_t)stride + ux;
+
+    if (!swap) {
+        // Each output row is one source row, forwards or backwards
+        for (int y = row; y < row + rows; y++) {
+            xform_run(src, origin + y * step_y, step_x, dst, out_w);
+            dst += (size_t)out_w * 3;
+        }
+        return;
+    }
+    if (out_w == 1) {
+        // A single source row, and the output rows follow each other
+        xform_run(src, origin + row * step_y, step_y, dst, rows);
+        return;
+    }
+
+    for (int ty = row; ty < row + rows; ty += XFORM_TILE) {
+        const int th = row + rows - ty < XFORM_TILE ? row + rows - ty : XFORM_TILE;
+        for (int tx = 0; tx < out_w; tx += XFORM_TILE) {
+            const int tw = out_w - tx < XFORM_TILE ? out_w - tx : XFORM_TILE;
+            for (int y = ty; y < ty + th; y++) {
+                xform_run(src, origin + y * step_y + tx * step_x, step_x,
+                          dst + ((size_t)(y - row) * out_w + tx) * 3, tw);
+            }
+        }
+    }
+}
+
+// Reads packed, MSB-first indices one at a time, loading each source
+// byte once and only when its first index is taken
+typedef struct {
+    const uint8_t *p;
+    uint32_t byte;
+    int left;                   // bits of byte not yet taken
+} index_reader_t;
+
+static inline void index_reader_init(index_reader_t *r, const uint8_t *src, size_t first,
+                                     int bits)
+{
+    size_t bit = first * bits;
+    r->p    = src + (bit >> 3);
+    r->left = 0;
+    if (bit & 7) {
+        r->byte = *r->p++;
+        r->left = 8 - (bit & 7);
+    }
+}
+
+static inline uint32_t index_next(index_reader_t *r, int bits)
+{
+    if (r->left == 0) {
+        r->byte = *r->p++;
+        r->left = 8;
+    }
+    r->left -= bits;
+    return (r->byte >> r->left) & ((1u << bits) - 1);
+}
+
+// Expansion to RGB666 or RGB565. Inlined once per index width below, so
+// that the reader works with constant shifts and masks.
+static inline __attribute__((always_inline))
+void index_expand(const uint8_t *src, size_t first, int bits, const uint32_t *palette,
+                  size_t bytes_per_pixel, uint8_t *dst, size_t pixels)
+{
+    index_reader_t r;
+    index_reader_init(&r, src, first, bits);
+    if (bytes_per_pixel == 2) {
+        for (size_t i = 0; i < pixels; i++) {
+            uint32_t v = palette[index_next(&r, bits)];
+            dst[0] = (uint8_t)v;
+            dst[1] = (uint8_t)(v >> 8);
+            dst += 2;
+        }
+        return;
+    }
+
+    size_t head = head_pixels(dst);
+    if (head > pixels) {
+        head = pixels;
+    }
+    for (size_t i = 0; i < head; i++) {
+        rgb666_store(dst, palette[index_next(&r, bits)]);
+        dst += 3;
+    }
+    pixels -= head;
+
+    uint32_t *out = (uint32_t *)(void *)dst;
+    for (size_t n = pixels >> 2; n > 0; n--) {
+        uint32_t a = palette[index_next(&r, bits)];
+        uint32_t b = palette[index_next(&r, bits)];
+        uint32_t c = palette[index_next(&r, bits)];
+        uint32_t d = palette[index_next(&r, bits)];
+        STORE_4PX(out, a, b, c, d);
+        out += 3;
+    }
+
+    dst = (uint8_t *)out;
+    for (size_t i = 0; i < (pixels & 3); i++) {
+        rgb666_store(dst, palette[index_next(&r, bits)]);
+        dst += 3;
+    }
+}
+
+void ili9486_index_to_wire(const uint8_t *src, size_t first, int bits,
+                           const uint32_t *palette, size_t bytes_per_pixel,
+                           uint8_t *dst, size_t pixels)
+{
+    switch (bits) {
+    case 1:  index_expand(src, first, 1, palette, bytes_per_pixel, dst, pixels); break;
+    case 2:  index_expand(src, first, 2, palette, bytes_per_pixel, dst, pixels); break;
+    case 4:  index_expand(src, first, 4, palette, bytes_per_pixel, dst, pixels); break;
+    default: index_expand(src, first, 8, palette, bytes_per_pixel, dst, pixels); break;
+    }
+}
+
+ili9486_conv_fn_t ili9486_conv_select(void)
+{
+#if CONFIG_ILI9486_CONV_KERNEL_SCALAR
+    return ili9486_rgb565_to_rgb666_ref;
+#elif CONFIG_ILI9486_CONV_KERNEL_WORD
+    return ili9486_rgb565_to_rgb666_word;
+#elif CONFIG_ILI9486_CONV_KERNEL_LUT
+    lut_init();
+    return ili9486_rgb565_to_rgb666_lut;
+#elif defined(__riscv)
+    // Single-issue RISC-V cores: two table loads beat the shift/mask chain
+    lut_init();
+    return ili9486_rgb565_to_rgb666_lut;
+#else
+    // Xtensa (and hosts): store-bound, so fewer, wider stores win. There is
+    // no ESP32-S3 PIE (SIMD) kernel yet; one would be picked here under
+    // CONFIG_IDF_TARGET_ESP32S3 once it is checked bit-exact on the chip.
+    return ili9486_rgb565_to_rgb666_word;
+#endif
+}
+
+const char *ili9486_conv_name(ili9486_conv_fn_t fn)
+{
+    if (fn == ili9486_rgb565_to_rgb666_ref)  return "scalar";
+    if (fn == ili9486_rgb565_to_rgb666_word) return "word";
+    if (fn == ili9486_rgb565_to_rgb666_lut)  return "lut";
+    return "unknown";
+}
@@ -0,0 +1,70 @@
+// ─── esp_ili9486_convert.h ──────────────────────────────────────────────────
+// RGB565 → RGB666 pixel conversion kernels.
+//
+// Every kernel produces exactly the same bytes as the scalar reference:
+// three bytes per pixel, R G B, each channel left-aligned in its byte.
+// Every kernel takes src and dst at any byte address: a src at an odd
+// address is read byte-wise, and the word kernels store byte-wise up to
+// the first aligned word of dst and after the last one.
+// They depend on nothing but the C library, so they can be built and
+// checked on a host as well as on the target.
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*ili9486_conv_fn_t)(const uint16_t *src, uint8_t *dst, size_t pixels);
+
+// One pixel per iteration, three byte stores. The reference.
+void ili9486_rgb565_to_rgb666_ref(const uint16_t *src, uint8_t *dst, size_t pixels);
+
+// Four pixels in, three aligned 32-bit words out. Up to three leading
+// pixels are converted byte-wise until dst is word aligned.
+void ili9486_rgb565_to_rgb666_word(const uint16_t *src, uint8_t *dst, size_t pixels);
+
+// Same word packing, with the channel split done by two 256-entry tables
+// indexed by the high and low byte of each pixel.
+void ili9486_rgb565_to_rgb666_lut(const uint16_t *src, uint8_t *dst, size_t pixels);
+
+// Source-to-output transform of the rotating kernel. Output pixel
+// (x, y) is mirrored first, then swapped, to find its source pixel.
+// 90 degrees clockwise is SWAP_XY | MIRROR_X, 180 is MIRROR_X | MIRROR_Y
+// and 270 is SWAP_XY | MIRROR_Y.
+typedef enum {
+    ILI9486_XFORM_NONE     = 0,
+    ILI9486_XFORM_MIRROR_X = 1 << 0,    // output columns right to left
+    ILI9486_XFORM_MIRROR_Y = 1 << 1,    // output rows bottom to top
+    ILI9486_XFORM_SWAP_XY  = 1 << 2,    // output rows are source columns
+} ili9486_xform_t;
+
+// Convert while transforming, in one pass: reads a width x height source
+// (stride pixels per row) in transformed order and writes output rows
+// [row, row + rows) packed, in output order. The output is height x width
+// with SWAP_XY. Word packed like the word kernel; transposed reads are
+// done in small tiles so the source lines they touch stay in the data
+// cache from one output row to the next.
+void ili9486_rgb565_to_rgb666_xform(const uint16_t *src, size_t stride,
+                                    int width, int height, ili9486_xform_t xform,
+                                    int row, int rows, uint8_t *dst);
+
+// Indexed pixels to wire format through a palette already in it:
+// palette[i] holds the bytes_per_pixel (3 for RGB666, 2 for big-endian
+// RGB565) wire bytes of entry i, first byte lowest. Indices are bits
+// (1, 2, 4 or 8) wide, packed MSB first; reading starts at index number
+// first of src. palette needs an entry for every value of bits.
+void ili9486_index_to_wire(const uint8_t *src, size_t first, int bits,
+                           const uint32_t *palette, size_t bytes_per_pixel,
+                           uint8_t *dst, size_t pixels);
+
+// The kernel for this target (or the one forced in menuconfig).
+ili9486_conv_fn_t ili9486_conv_select(void);
+
+// Human readable kernel name, for logs and benchmarks.
+const char *ili9486_conv_name(ili9486_conv_fn_t fn);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,429 @@
+// ─── esp_ili9486_mock_io.c ──────────────────────────────────────────────────
+// ILI9486 emulator behind the esp_lcd panel IO interface. Each transfer
+// is decoded as the controller would: a command byte, then its parameters
+// or, after RAMWR / RAMWRC, pixels written into GRAM at the address
+// counter. The counter walks the CASET/RASET window in the order MADCTL
+// selects. Transfers complete synchronously, so tx_color() raises
+// on_color_trans_done before it returns.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_check.h"
+#include "esp_lcd_panel_io_interface.h"
+#include "esp_ili9486_mock_io.h"
+
+static const char *TAG = "ili9486_mock";
+
+#define MOCK_COLS 320
+#define MOCK_ROWS 480
+
+#define CMD_SWRESET  0x01
+#define CMD_SLPIN    0x10
+#define CMD_SLPOUT   0x11
+#define CMD_NORON    0x13
+#define CMD_INVOFF   0x20
+#define CMD_INVON    0x21
+#define CMD_DISPOFF  0x28
+#define CMD_DISPON   0x29
+#define CMD_CASET    0x2A
+#define CMD_RASET    0x2B
+#define CMD_RAMWR    0x2C
+#define CMD_VSCRDEF  0x33
+#define CMD_TEOFF    0x34
+#define CMD_TEON     0x35
+#define CMD_MADCTL   0x36
+#define CMD_VSCRSADD 0x37
+#define CMD_COLMOD   0x3A
+#define CMD_RAMWRC   0x3C
+
+#define MADCTL_MY    0x80
+#define MADCTL_MX    0x40
+#define MADCTL_MV    0x20
+#define MADCTL_BGR   0x08
+
+#define MAX_PARAMS   16     // bytes kept per command, after unpadding: 2x
+
+typedef struct {
+    esp_lcd_panel_io_t base;
+    esp_lcd_panel_io_callbacks_t cbs;
+    void *user_ctx;
+    uint8_t (*gram)[MOCK_COLS][3];      // NULL with flags.no_gram
+    esp_lcd_ili9486_mock_state_t state;
+    esp_lcd_ili9486_mock_stats_t stats;
+    // Address window and counter, in MADCTL (logical) coordinates
+    int sc, ec, sp, ep;
+    int col, page;
+    // Decoder
+    int cmd;                            // -1: none since reset
+    uint8_t param[2 * MAX_PARAMS];
+    size_t n_param;
+    uint8_t pix[3];
+    int n_pix;
+} mock_io_t;
+
+static void mock_reset_state(mock_io_t *m)
+{
+    m->state = (esp_lcd_ili9486_mock_state_t){
+        .colmod       = 0x66,
+        .sleeping     = true,
+        .scroll_lines = MOCK_ROWS,
+    };
+    m->sc = 0;
+    m->ec = MOCK_COLS - 1;
+    m->sp = 0;
+    m->ep = MOCK_ROWS - 1;
+    m->col  = 0;
+    m->page = 0;
+}
+
+// Parameter i of the current command, plain or padded to 16-bit words
+static int mock_param(const mock_io_t *m, size_t expect, size_t i)
+{
+    return m->n_param == 2 * expect ? m->param[2 * i + 1] : m->param[i];
+}
+
+static bool mock_params_ok(mock_io_t *m, size_t expect)
+{
+    if (m->n_param == expect || m->n_param == 2 * expect) {
+        return true;
+    }
+    m->stats.protocol_errors++;
+    return false;
+}
+
+static int mock_u16(const mock_io_t *m, size_t expect, size_t i)
+{
+    return (mock_param(m, expect, i) << 8) | mock_param(m, expect, i + 1);
+}
+
+// Apply the parameters gathered for the current command. Called at the
+// end of each transfer that carried them.
+static void mock_apply_params(mock_io_t *m)
+{
+    esp_lcd_ili9486_mock_state_t *st = &m->state;
+    const bool mv = st->madctl & MADCTL_MV;
+    int a, b;
+
+    switch (m->cmd) {
+    case CMD_CASET:
+    case CMD_RASET:
+        if (!mock_params_ok(m, 4)) {
+            break;
+        }
+        a = mock_u16(m, 4, 0);
+        b = mock_u16(m, 4, 2);
+        // With MV the column counter runs along the 480-line axis
+        if (a > b || b >= (((m->cmd == CMD_CASET) != mv) ? MOCK_COLS : MOCK_ROWS)) {
+            m->stats.protocol_errors++;
+            break;
+        }
+        if (m->cmd == CMD_CASET) {
+            m->sc = a;
+            m->ec = b;
+        } else {
+            m->sp = a;
+            m->ep = b;
+        }
+        break;
+    case CMD_MADCTL:
+        if (mock_params_ok(m, 1)) {
+            st->madctl = mock_param(m, 1, 0);
+        }
+        break;
+    case CMD_COLMOD:
+        if (mock_params_ok(m, 1)) {
+            st->colmod = mock_param(m, 1, 0);
+        }
+        break;
+    case CMD_TEON:
+        if (mock_params_ok(m, 1)) {
+            st->te_on = true;
+        }
+        break;
+    case CMD_VSCRDEF:
+        if (!mock_params_ok(m, 6)) {
+            break;
+        }
+        a = mock_u16(m, 6, 0);
+        b = mock_u16(m, 6, 2);
+        if (a + b + mock_u16(m, 6, 4) != MOCK_ROWS) {
+            m->stats.protocol_errors++;
+            break;
+        }
+        st->top_fixed    = a;
+        st->scroll_lines = b;
+        st->bottom_fixed = mock_u16(m, 6, 4);
+        break;
+    case CMD_VSCRSADD:
+        if (mock_params_ok(m, 2)) {
+            st->scroll_start = mock_u16(m, 2, 0);
+            st->scrolling    = true;
+        }
+        break;
+    default:
+        break;
+    }
+    m->n_param = 0;
+}
+
+static void mock_command(mock_io_t *m, int cmd)
+{
+    esp_lcd_ili9486_mock_state_t *st = &m->state;
+
+    m->cmd   = cmd & 0xFF;
+    m->n_pix = 0;
+    m->stats.commands++;
+    m->stats.cmd_count[m->cmd]++;
+
+    switch (m->cmd) {
+    case CMD_SWRESET:
+        mock_reset_state(m);
+        break;
+    case CMD_SLPIN:
+        st->sleeping = true;
+        break;
+    case CMD_SLPOUT:
+        st->sleeping = false;
+        break;
+    case CMD_NORON:
+        st->scrolling = false;
+        break;
+    case CMD_INVOFF:
+    case CMD_INVON:
+        st->inverted = m->cmd == CMD_INVON;
+        break;
+    case CMD_DISPOFF:
+    case CMD_DISPON:
+        st->display_on = m->cmd == CMD_DISPON;
+        break;
+    case CMD_TEOFF:
+        st->te_on = false;
+        break;
+    case CMD_RAMWR:
+        m->col  = m->sc;
+        m->page = m->sp;
+        break;
+    default:
+        break;
+    }
+}
+
+static void mock_store_pixel(mock_io_t *m, uint8_t r, uint8_t g, uint8_t b)
+{
+    const uint8_t madctl = m->state.madctl;
+    int x = (madctl & MADCTL_MV) ? m->page : m->col;
+    int y = (madctl & MADCTL_MV) ? m->col : m->page;
+    if (madctl & MADCTL_MX) {
+        x = MOCK_COLS - 1 - x;
+    }
+    if (madctl & MADCTL_MY) {
+        y = MOCK_ROWS - 1 - y;
+    }
+    // Red and blue are swapped on the glass of these modules; BGR undoes it
+    if (!(madctl & MADCTL_BGR)) {
+        uint8_t t = r;
+        r = b;
+        b = t;
+    }
+    if (m->gram) {
+        m->gram[y][x][0] = r;
+        m->gram[y][x][1] = g;
+        m->gram[y][x][2] = b;
+    }
+    m->stats.pixels++;
+
+    // The counter wraps within the window
+    if (++m->col > m->ec) {
+        m->col = m->sc;
+        if (++m->page > m->ep) {
+            m->page = m->sp;
+        }
+    }
+}
+
+static void mock_pixel_bytes(mock_io_t *m, const uint8_t *data, size_t len)
+{
+    const bool rgb565 = (m->state.colmod & 0x0F) == 0x05;
+    const int bytes = rgb565 ? 2 : 3;
+
+    m->stats.pixel_bytes += len;
+    for (size_t i = 0; i < len; i++) {
+        m->pix[m->n_pix++] = data[i];
+        if (m->n_pix < bytes) {
+            continue;
+        }
+        m->n_pix = 0;
+        if (rgb565) {
+            // Big-endian 5-6-5; red and blue widen by repeating their MSB
+            uint8_t r5 = m->pix[0] >> 3;
+            uint8_t g6 = ((m->pix[0] & 0x07) << 3) | (m->pix[1] >> 5);
+            uint8_t b5 = m->pix[1] & 0x1F;
+            mock_store_pixel(m, (r5 << 1) | (r5 >> 4), g6, (b5 << 1) | (b5 >> 4));
+        } else {
+            // One byte per channel, upper six bits used
+            mock_store_pixel(m, m->pix[0] >> 2, m->pix[1] >> 2, m->pix[2] >> 2);
+        }
+    }
+}
+
+static void mock_data(mock_io_t *m, const void *data, size_t len)
+{
+    if (!data || !len) {
+        return;
+    }
+    if (m->cmd < 0) {
+        m->stats.protocol_errors++;
+        return;
+    }
+    if (m->cmd == CMD_RAMWR || m->cmd == CMD_RAMWRC) {
+        mock_pixel_bytes(m, data, len);
+        return;
+    }
+    m->stats.param_bytes += len;
+    size_t keep = sizeof(m->param) - m->n_param;
+    memcpy(m->param + m->n_param, data, len < keep ? len : keep);
+    m->n_param += len;
+    mock_apply_params(m);
+}
+
+static esp_err_t mock_tx_param(esp_lcd_panel_io_t *io, int lcd_cmd, const void *param,
+                               size_t param_size)
+{
+    mock_io_t *m = __containerof(io, mock_io_t, base);
+    m->stats.tx_param_calls++;
+    if (lcd_cmd >= 0) {
+        mock_command(m, lcd_cmd);
+    }
+    mock_data(m, param, param_size);
+    return ESP_OK;
+}
+
+static esp_err_t mock_tx_color(esp_lcd_panel_io_t *io, int lcd_cmd, const void *color,
+                               size_t color_size)
+{
+    mock_io_t *m = __containerof(io, mock_io_t, base);
+    m->stats.tx_color_calls++;
+    if (lcd_cmd >= 0) {
+        mock_command(m, lcd_cmd);
+    }
+    mock_data(m, color, color_size);
+    if (m->cbs.on_color_trans_done) {
+        m->cbs.on_color_trans_done(io, NULL, m->user_ctx);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t mock_register_event_callbacks(esp_lcd_panel_io_t *io,
+                                               const esp_lcd_panel_io_callbacks_t *cbs,
+                                               void *user_ctx)
+{
+    mock_io_t *m = __containerof(io, mock_io_t, base);
+    m->cbs = *cbs;
+    m->user_ctx = user_ctx;
+    return ESP_OK;
+}
+
+static esp_err_t mock_del(esp_lcd_panel_io_t *io)
+{
+    mock_io_t *m = __containerof(io, mock_io_t, base);
+    free(m->gram);
+    free(m);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_io_ili9486_mock(const esp_lcd_ili9486_mock_config_t *config,
+                                            esp_lcd_panel_io_handle_t *ret_io)
+{
+    ESP_RETURN_ON_FALSE(ret_io, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    mock_io_t *m = calloc(1, sizeof(mock_io_t));
+    ESP_RETURN_ON_FALSE(m, ESP_ERR_NO_MEM, TAG, "no memory for mock IO");
+
+    if (!(config && config->flags.no_gram)) {
+        m->gram = calloc(MOCK_ROWS, sizeof(m->gram[0]));
+        if (!m->gram) {
+            free(m);
+            ESP_LOGE(TAG, "no memory for emulated GRAM");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    m->base.tx_param                 = mock_tx_param;
+    m->base.tx_color                 = mock_tx_color;
+    m->base.del                      = mock_del;
+    m->base.register_event_callbacks = mock_register_event_callbacks;
+    m->cmd = -1;
+    mock_reset_state(m);
+
+    *ret_io = &m->base;
+    return ESP_OK;
+}
+
+// GRAM line shown on display row y: rows in the scroll area are taken
+// from VSCRSADD onwards, wrapping within the area
+static int mock_shown_line(const mock_io_t *m, int y)
+{
+    const esp_lcd_ili9486_mock_state_t *st = &m->state;
+    const int first = st->top_fixed;
+    if (!st->scrolling || y < first || y >= first + st->scroll_lines) {
+        return y;
+    }
+    int offset = st->scroll_start - first;
+    if (offset < 0 || offset >= st->scroll_lines) {
+        return y;       // start outside the area: the panel ignores it
+    }
+    return first + (y - first + offset) % st->scroll_lines;
+}
+
+esp_err_t esp_lcd_ili9486_mock_get_pixel(esp_lcd_panel_io_handle_t io, int x, int y,
+                                         uint8_t rgb[3])
+{
+    ESP_RETURN_ON_FALSE(io && rgb, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(x >= 0 && x < MOCK_COLS && y >= 0 && y < MOCK_ROWS,
+                        ESP_ERR_INVALID_ARG, TAG, "pixel (%d,%d) out of range", x, y);
+    mock_io_t *m = __containerof(io, mock_io_t, base);
+    ESP_RETURN_ON_FALSE(m->gram, ESP_ERR_INVALID_STATE, TAG, "created with no_gram");
+    memcpy(rgb, m->gram[mock_shown_line(m, y)][x], 3);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_ili9486_mock_get_state(esp_lcd_panel_io_handle_t io,
+                                         esp_lcd_ili9486_mock_state_t *state)
+{
+    ESP_RETURN_ON_FALSE(io && state, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    mock_io_t *m = __containerof(io, mock_io_t, base);
+    *state = m->state;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_ili9486_mock_get_stats(esp_lcd_panel_io_handle_t io,
+                                         esp_lcd_ili9486_mock_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(io && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    mock_io_t *m = __containerof(io, mock_io_t, base);
+    *stats = m->stats;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_ili9486_mock_reset_stats(esp_lcd_panel_io_handle_t io)
+{
+    ESP_RETURN_ON_FALSE(io, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    mock_io_t *m = __containerof(io, mock_io_t, base);
+    memset(&m->stats, 0, sizeof(m->stats));
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_ili9486_mock_dump_ppm(esp_lcd_panel_io_handle_t io, const char *path)
+{
+    ESP_RETURN_ON_FALSE(io && path, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    mock_io_t *m = __containerof(io, mock_io_t, base);
+    ESP_RETURN_ON_FALSE(m->gram, ESP_ERR_INVALID_STATE, TAG, "created with no_gram");
+    FILE *f = fopen(path, "wb");
+    ESP_RETURN_ON_FALSE(f, ESP_FAIL, TAG, "cannot open %s", path);
+
+    bool ok = fprintf(f, "P6\n%d %d\n63\n", MOCK_COLS, MOCK_ROWS) > 0;
+    for (int y = 0; y < MOCK_ROWS && ok; y++) {
+        ok = fwrite(m->gram[mock_shown_line(m, y)], 3, MOCK_COLS, f) == MOCK_COLS;
+    }
+    ok = (fclose(f) == 0) && ok;
+    ESP_RETURN_ON_FALSE(ok, ESP_FAIL, TAG, "write to %s failed", path);
+    return ESP_OK;
+}
@@ -0,0 +1,532 @@
+// ─── esp_ili9486_multi.c ────────────────────────────────────────────────────
+// Several panels: a converter task shared by the panels on one bus (bus
+// group), and one panel handle drawing across several panels (span).
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_memory_utils.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_ili9486_multi.h"
+#include "esp_ili9486_priv.h"
+
+static const char *TAG = "ili9486_multi";
+
+// ── Bus group ────────────────────────────────────────────────────────────────
+
+#if CONFIG_ILI9486_CONVERTER_TASK
+
+#if CONFIG_ILI9486_CONVERTER_TASK_CORE < 0
+#define GROUP_CORE tskNO_AFFINITY
+#else
+#define GROUP_CORE CONFIG_ILI9486_CONVERTER_TASK_CORE
+#endif
+
+// The group task is the consumer of every member's ring. lock keeps the
+// member list still while a region is picked and flushed.
+struct esp_lcd_ili9486_bus_group_t {
+    ili9486_bus_sched_t sched;
+    TaskHandle_t task;
+    SemaphoreHandle_t lock;
+    SemaphoreHandle_t exited;
+    volatile bool exit;
+    int count;
+    int next;                       // round-robin: first member to look at
+    ili9486_panel_t *members[ILI9486_BUS_GROUP_MAX_PANELS];
+    uint32_t deadline_us[ILI9486_BUS_GROUP_MAX_PANELS];
+};
+
+// Member whose oldest region goes next, or -1 if every ring is empty
+static int bus_group_pick(struct esp_lcd_ili9486_bus_group_t *g)
+{
+    int best = -1;
+    int64_t best_due = 0;
+    for (int k = 0; k < g->count; k++) {
+        int i = (g->next + k) % g->count;
+        const ili9486_region_t *r = ili9486_worker_peek(g->members[i]);
+        if (!r) {
+            continue;
+        }
+        if (g->sched == ILI9486_BUS_SCHED_ROUND_ROBIN) {
+            best = i;
+            break;
+        }
+        int64_t due = r->t_draw_us + g->deadline_us[i];
+        if (best < 0 || due < best_due) {
+            best     = i;
+            best_due = due;
+        }
+    }
+    if (best >= 0) {
+        g->next = (best + 1) % g->count;
+    }
+    return best;
+}
+
+static void bus_group_task(void *arg)
+{
+    struct esp_lcd_ili9486_bus_group_t *g = arg;
+
+    while (!g->exit) {
+        xSemaphoreTake(g->lock, portMAX_DELAY);
+        int i = bus_group_pick(g);
+        if (i >= 0) {
+            ili9486_worker_run_one(g->members[i]);
+        }
+        xSemaphoreGive(g->lock);
+        if (i < 0) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+
+    xSemaphoreGive(g->exited);
+    vTaskDelete(NULL);
+}
+
+static int bus_group_find(const struct esp_lcd_ili9486_bus_group_t *g,
+                          const ili9486_panel_t *ili)
+{
+    for (int i = 0; i < g->count; i++) {
+        if (g->members[i] == ili) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Drop a member; the caller holds the lock
+static void bus_group_remove(struct esp_lcd_ili9486_bus_group_t *g, int i)
+{
+    memmove(&g->members[i], &g->members[i + 1], (g->count - i - 1) * sizeof(g->members[0]));
+    memmove(&g->deadline_us[i], &g->deadline_us[i + 1],
+            (g->count - i - 1) * sizeof(g->deadline_us[0]));
+    g->count--;
+    g->next = 0;
+}
+
+esp_err_t esp_lcd_ili9486_bus_group_new(const esp_lcd_ili9486_bus_group_config_t *config,
+                                        esp_lcd_ili9486_bus_group_handle_t *ret_group)
+{
+    ESP_RETURN_ON_FALSE(config && ret_group, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ESP_RETURN_ON_FALSE(config->sched == ILI9486_BUS_SCHED_ROUND_ROBIN ||
+                        config->sched == ILI9486_BUS_SCHED_DEADLINE, ESP_ERR_INVALID_ARG,
+                        TAG, "unknown scheduling policy %d", config->sched);
+
+    esp_err_t ret = ESP_OK;
+    struct esp_lcd_ili9486_bus_group_t *g = calloc(1, sizeof(*g));
+    ESP_RETURN_ON_FALSE(g, ESP_ERR_NO_MEM, TAG, "no memory for bus group");
+    g->sched  = config->sched;
+    g->lock   = xSemaphoreCreateMutex();
+    g->exited = xSemaphoreCreateBinary();
+    ESP_GOTO_ON_FALSE(g->lock && g->exited, ESP_ERR_NO_MEM, err, TAG, "no memory for bus group");
+
+    BaseType_t ok = xTaskCreatePinnedToCore(bus_group_task, "ili9486_bus",
+                                            CONFIG_ILI9486_CONVERTER_TASK_STACK_SIZE,
+                                            g, CONFIG_ILI9486_CONVERTER_TASK_PRIORITY,
+                                            &g->task, GROUP_CORE);
+    ESP_GOTO_ON_FALSE(ok == pdPASS, ESP_ERR_NO_MEM, err, TAG, "bus group task start failed");
+
+    *ret_group = g;
+    return ESP_OK;
+
+err:
+    if (g->lock) {
+        vSemaphoreDelete(g->lock);
+    }
+    if (g->exited) {
+        vSemaphoreDelete(g->exited);
+    }
+    free(g);
+    return ret;
+}
+
+esp_err_t esp_lcd_ili9486_bus_group_add_panel(esp_lcd_ili9486_bus_group_handle_t group,
+                                              esp_lcd_panel_handle_t panel,
+                                              uint32_t deadline_us)
+{
+    ESP_RETURN_ON_FALSE(group && panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ESP_RETURN_ON_FALSE(!ili->worker.group, ESP_ERR_INVALID_STATE, TAG,
+                        "panel already in a bus group");
+
+    esp_err_t ret = ESP_OK;
+    xSemaphoreTake(group->lock, portMAX_DELAY);
+    ESP_GOTO_ON_FALSE(group->count < ILI9486_BUS_GROUP_MAX_PANELS, ESP_ERR_NO_MEM, out, TAG,
+                      "bus group full");
+    // Drains the panel's ring, so its own task ends with nothing pending
+    ESP_GOTO_ON_ERROR(ili9486_worker_set_group(ili, group, group->task), out, TAG,
+                      "converter task hand-over failed");
+    group->members[group->count]     = ili;
+    group->deadline_us[group->count] = deadline_us;
+    group->count++;
+out:
+    xSemaphoreGive(group->lock);
+    return ret;
+}
+
+esp_err_t esp_lcd_ili9486_bus_group_remove_panel(esp_lcd_ili9486_bus_group_handle_t group,
+                                                 esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(group && panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ESP_RETURN_ON_FALSE(ili->worker.group == group, ESP_ERR_NOT_FOUND, TAG,
+                        "panel not in this bus group");
+
+    // The group task must be free to drain the ring, so wait before
+    // taking the lock
+    ili9486_worker_sync(ili);
+    xSemaphoreTake(group->lock, portMAX_DELAY);
+    bus_group_remove(group, bus_group_find(group, ili));
+    xSemaphoreGive(group->lock);
+    return ili9486_worker_set_group(ili, NULL, NULL);
+}
+
+void ili9486_bus_group_leave(struct esp_lcd_ili9486_bus_group_t *group, ili9486_panel_t *ili)
+{
+    xSemaphoreTake(group->lock, portMAX_DELAY);
+    int i = bus_group_find(group, ili);
+    if (i >= 0) {
+        bus_group_remove(group, i);
+    }
+    xSemaphoreGive(group->lock);
+}
+
+esp_err_t esp_lcd_ili9486_bus_group_del(esp_lcd_ili9486_bus_group_handle_t group)
+{
+    ESP_RETURN_ON_FALSE(group, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    while (group->count > 0) {
+        ESP_RETURN_ON_ERROR(esp_lcd_ili9486_bus_group_remove_panel(group,
+                                                                   &group->members[0]->base),
+                            TAG, "panel removal failed");
+    }
+
+    group->exit = true;
+    xTaskNotifyGive(group->task);
+    xSemaphoreTake(group->exited, portMAX_DELAY);
+    vSemaphoreDelete(group->lock);
+    vSemaphoreDelete(group->exited);
+    free(group);
+    return ESP_OK;
+}
+
+#else
+
+esp_err_t esp_lcd_ili9486_bus_group_new(const esp_lcd_ili9486_bus_group_config_t *config,
+                                        esp_lcd_ili9486_bus_group_handle_t *ret_group)
+{
+    ESP_LOGE(TAG, "bus groups need CONFIG_ILI9486_CONVERTER_TASK");
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_lcd_ili9486_bus_group_add_panel(esp_lcd_ili9486_bus_group_handle_t group,
+                                              esp_lcd_panel_handle_t panel,
+                                              uint32_t deadline_us)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_lcd_ili9486_bus_group_remove_panel(esp_lcd_ili9486_bus_group_handle_t group,
+                                                 esp_lcd_panel_handle_t panel)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+esp_err_t esp_lcd_ili9486_bus_group_del(esp_lcd_ili9486_bus_group_handle_t group)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+#endif // CONFIG_ILI9486_CONVERTER_TASK
+
+// ── Span panel ───────────────────────────────────────────────────────────────
+
+// Draws not fully released yet, oldest first
+#define SPAN_PENDING 32
+
+typedef struct ili9486_span_panel_t ili9486_span_panel_t;
+
+// user_ctx of the callbacks registered on a member
+typedef struct {
+    ili9486_span_panel_t *span;
+    uint32_t bit;
+} ili9486_span_member_t;
+
+struct ili9486_span_panel_t {
+    esp_lcd_panel_t base;
+    ili9486_panel_t *panels[ILI9486_SPAN_MAX_PANELS];
+    ili9486_span_member_t members[ILI9486_SPAN_MAX_PANELS];
+    int count;
+    ili9486_span_layout_t layout;
+    esp_lcd_panel_ili9486_callbacks_t cbs;
+    void *user_ctx;
+    bool cbs_registered;
+    // Per pending draw, the members that still hold a piece of it. Each
+    // member releases its pieces in draw order, so a release clears the
+    // member's bit in the oldest entry that has it.
+    portMUX_TYPE lock;
+    uint32_t pending[SPAN_PENDING];
+    uint32_t head;                  // written by the drawing task
+    uint32_t tail;                  // under lock
+};
+
+// Member size in the members' current orientation
+static void span_member_size(const ili9486_span_panel_t *s, int *w, int *h)
+{
+    *w = s->panels[0]->width;
+    *h = s->panels[0]->height;
+}
+
+static bool span_on_src_released(esp_lcd_panel_handle_t panel, void *user_ctx)
+{
+    ili9486_span_member_t *m = user_ctx;
+    ili9486_span_panel_t *s = m->span;
+    int done = 0;
+
+    portENTER_CRITICAL_SAFE(&s->lock);
+    for (uint32_t i = s->tail; i != s->head; i++) {
+        uint32_t *e = &s->pending[i % SPAN_PENDING];
+        if (*e & m->bit) {
+            *e &= ~m->bit;
+            break;
+        }
+    }
+    while (s->tail != s->head && s->pending[s->tail % SPAN_PENDING] == 0) {
+        s->tail++;
+        done++;
+    }
+    portEXIT_CRITICAL_SAFE(&s->lock);
+
+    bool need_yield = false;
+    while (done--) {
+        need_yield |= s->cbs.on_src_released(&s->base, s->user_ctx);
+    }
+    return need_yield;
+}
+
+static esp_err_t span_draw_bitmap(esp_lcd_panel_t *panel, int x_start, int y_start,
+                                  int x_end, int y_end, const void *color_data)
+{
+    ili9486_span_panel_t *s = __containerof(panel, ili9486_span_panel_t, base);
+    int w, h;
+    span_member_size(s, &w, &h);
+    const int stride = x_end - x_start;
+    const int bpp = s->panels[0]->src_bytes_per_pixel;
+    const bool zero_copy = s->panels[0]->zero_copy;
+    const bool track = s->cbs_registered && s->cbs.on_src_released;
+
+    // Zero-copy members check the buffer too, but only once the draw is
+    // half queued
+    ESP_RETURN_ON_FALSE(!zero_copy || esp_ptr_dma_capable(color_data) ||
+                        esp_ptr_dma_ext_capable(color_data), ESP_ERR_INVALID_ARG, TAG,
+                        "color_data must be DMA-capable in zero-copy mode");
+
+    ili9486_region_t pieces[ILI9486_SPAN_MAX_PANELS];
+    uint32_t mask = 0;
+    for (int i = 0; i < s->count; i++) {
+        int ox = s->layout == ILI9486_SPAN_HORIZONTAL ? i * w : 0;
+        int oy = s->layout == ILI9486_SPAN_VERTICAL ? i * h : 0;
+        int x0 = MAX(x_start, ox);
+        int y0 = MAX(y_start, oy);
+        int x1 = MIN(x_end, ox + w);
+        int y1 = MIN(y_end, oy + h);
+        if (x0 >= x1 || y0 >= y1) {
+            continue;
+        }
+        pieces[i] = (ili9486_region_t) {
+            .x_start    = x0 - ox,
+            .y_start    = y0 - oy,
+            .x_end      = x1 - ox,
+            .y_end      = y1 - oy,
+            .color_data = (const uint8_t *)color_data +
+                          ((size_t)(y0 - y_start) * stride + (x0 - x_start)) * bpp,
+            .stride     = stride,
+#if CONFIG_ILI9486_ENABLE_STATS || CONFIG_ILI9486_CONVERTER_TASK
+            .t_draw_us  = esp_timer_get_time(),
+#endif
+        };
+        mask |= 1u << i;
+    }
+
+    if (!mask) {
+        if (track) {
+            s->cbs.on_src_released(&s->base, s->user_ctx);
+        }
+        return ESP_OK;
+    }
+
+    if (track) {
+        // The oldest draws are released by the members in the background
+        while (s->head - *(volatile uint32_t *)&s->tail == SPAN_PENDING) {
+            vTaskDelay(1);
+        }
+        portENTER_CRITICAL(&s->lock);
+        s->pending[s->head % SPAN_PENDING] = mask;
+        s->head++;
+        portEXIT_CRITICAL(&s->lock);
+    }
+
+    // Every piece is submitted, so each member releases its piece even if
+    // another one failed
+    esp_err_t ret = ESP_OK;
+    for (int i = 0; i < s->count; i++) {
+        if (mask & (1u << i)) {
+            esp_err_t err = ili9486_draw_region(s->panels[i], &pieces[i]);
+            if (ret == ESP_OK) {
+                ret = err;
+            }
+        }
+    }
+    return ret;
+}
+
+static esp_err_t span_reset(esp_lcd_panel_t *panel)
+{
+    ili9486_span_panel_t *s = __containerof(panel, ili9486_span_panel_t, base);
+    for (int i = 0; i < s->count; i++) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_reset(&s->panels[i]->base), TAG, "reset failed");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t span_init(esp_lcd_panel_t *panel)
+{
+    ili9486_span_panel_t *s = __containerof(panel, ili9486_span_panel_t, base);
+    for (int i = 0; i < s->count; i++) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_init(&s->panels[i]->base), TAG, "init failed");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t span_invert_color(esp_lcd_panel_t *panel, bool invert)
+{
+    ili9486_span_panel_t *s = __containerof(panel, ili9486_span_panel_t, base);
+    for (int i = 0; i < s->count; i++) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_invert_color(&s->panels[i]->base, invert), TAG,
+                            "invert failed");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t span_disp_on_off(esp_lcd_panel_t *panel, bool on)
+{
+    ili9486_span_panel_t *s = __containerof(panel, ili9486_span_panel_t, base);
+    for (int i = 0; i < s->count; i++) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_disp_on_off(&s->panels[i]->base, on), TAG,
+                            "display on/off failed");
+    }
+    return ESP_OK;
+}
+
+static esp_err_t span_mirror(esp_lcd_panel_t *panel, bool mx, bool my)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static esp_err_t span_swap_xy(esp_lcd_panel_t *panel, bool swap)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static esp_err_t span_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap)
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+static esp_err_t span_del(esp_lcd_panel_t *panel)
+{
+    ili9486_span_panel_t *s = __containerof(panel, ili9486_span_panel_t, base);
+    if (s->cbs_registered) {
+        // Also waits for the pieces still in flight, which call back here
+        const esp_lcd_panel_ili9486_callbacks_t none = {0};
+        for (int i = 0; i < s->count; i++) {
+            esp_lcd_panel_ili9486_register_event_callbacks(&s->panels[i]->base, &none, NULL);
+        }
+    }
+    free(s);
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_new_panel_ili9486_span(const esp_lcd_ili9486_span_config_t *config,
+                                         esp_lcd_panel_handle_t *ret_panel)
+{
+    ESP_RETURN_ON_FALSE(config && ret_panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ESP_RETURN_ON_FALSE(config->panel_count > 0 && config->panel_count <= ILI9486_SPAN_MAX_PANELS,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid panel count %d", config->panel_count);
+    ESP_RETURN_ON_FALSE(config->layout == ILI9486_SPAN_HORIZONTAL ||
+                        config->layout == ILI9486_SPAN_VERTICAL, ESP_ERR_INVALID_ARG, TAG,
+                        "unknown layout %d", config->layout);
+
+    ili9486_panel_t *first = NULL;
+    for (int i = 0; i < config->panel_count; i++) {
+        ESP_RETURN_ON_FALSE(config->panels[i], ESP_ERR_INVALID_ARG, TAG, "panel %d missing", i);
+        ili9486_panel_t *ili = __containerof(config->panels[i], ili9486_panel_t, base);
+        if (!first) {
+            first = ili;
+        }
+        ESP_RETURN_ON_FALSE(ili->width == first->width &&
+                            ili->src_bytes_per_pixel == first->src_bytes_per_pixel &&
+                            ili->zero_copy == first->zero_copy, ESP_ERR_INVALID_ARG, TAG,
+                            "panel %d differs in orientation or pixel format", i);
+        for (int j = 0; j < i; j++) {
+            ESP_RETURN_ON_FALSE(config->panels[j] != config->panels[i], ESP_ERR_INVALID_ARG,
+                                TAG, "panel %d listed twice", i);
+        }
+    }
+
+    ili9486_span_panel_t *s = calloc(1, sizeof(*s));
+    ESP_RETURN_ON_FALSE(s, ESP_ERR_NO_MEM, TAG, "no memory for span panel");
+    s->count  = config->panel_count;
+    s->layout = config->layout;
+    portMUX_INITIALIZE(&s->lock);
+    for (int i = 0; i < s->count; i++) {
+        s->panels[i]       = __containerof(config->panels[i], ili9486_panel_t, base);
+        s->members[i].span = s;
+        s->members[i].bit  = 1u << i;
+    }
+
+    s->base.del          = span_del;
+    s->base.reset        = span_reset;
+    s->base.init         = span_init;
+    s->base.draw_bitmap  = span_draw_bitmap;
+    s->base.invert_color = span_invert_color;
+    s->base.mirror       = span_mirror;
+    s->base.swap_xy      = span_swap_xy;
+    s->base.set_gap      = span_set_gap;
+    s->base.disp_on_off  = span_disp_on_off;
+
+    *ret_panel = &s->base;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_ili9486_span_register_event_callbacks(
+    esp_lcd_panel_handle_t span,
+    const esp_lcd_panel_ili9486_callbacks_t *cbs,
+    void *user_ctx)
+{
+    ESP_RETURN_ON_FALSE(span && cbs, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ESP_RETURN_ON_FALSE(!cbs->on_flush_done, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "on_flush_done is not supported on a span");
+    ili9486_span_panel_t *s = __containerof(span, ili9486_span_panel_t, base);
+
+    // Registering on a member drains it, so no release from the old
+    // callbacks is left to come when the FIFO is emptied
+    const esp_lcd_panel_ili9486_callbacks_t member_cbs = {
+        .on_src_released = cbs->on_src_released ? span_on_src_released : NULL,
+    };
+    for (int i = 0; i < s->count; i++) {
+        ESP_RETURN_ON_ERROR(esp_lcd_panel_ili9486_register_event_callbacks(
+                                &s->panels[i]->base, &member_cbs, &s->members[i]),
+                            TAG, "member callback registration failed");
+    }
+    s->cbs            = *cbs;
+    s->user_ctx       = user_ctx;
+    s->head           = 0;
+    s->tail           = 0;
+    s->cbs_registered = true;
+    return ESP_OK;
+}
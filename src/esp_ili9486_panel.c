@@ -1,17 +1,25 @@
 // ─── ili9486_panel.c ────────────────────────────────────────────────────────
 #include <string.h>
+#include <sys/param.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
 #include "esp_log.h"
 #include "esp_check.h"
 #include "esp_heap_caps.h"
+#include "esp_memory_utils.h"
+#include "esp_timer.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
 #include "esp_lcd_types.h"
 #include "esp_lcd_panel_io.h"
 #include "esp_lcd_panel_ops.h"
 #include "esp_lcd_panel_vendor.h"
 #include "esp_lcd_panel_interface.h"
+#include "soc/soc_caps.h"
 #include "esp_ili9486_panel.h"
+#include "esp_ili9486_priv.h"
+#include "esp_ili9486_convert.h"
 
 static const char *TAG = "ili9486";
 
@@ -23,34 +31,26 @@ static const char *TAG = "ili9486";
 #define ILI9486_CMD_CASET    0x2A
 #define ILI9486_CMD_RASET    0x2B
 #define ILI9486_CMD_RAMWR    0x2C
+#define ILI9486_CMD_RAMWRC   0x3C
+#define ILI9486_CMD_VSCRDEF  0x33
+#define ILI9486_CMD_VSCRSADD 0x37
+#define ILI9486_CMD_NORON    0x13
+#define ILI9486_CMD_TEON     0x35
 #define ILI9486_CMD_INVON    0x21
 #define ILI9486_CMD_INVOFF   0x20
 
-typedef struct {
-    esp_lcd_panel_t base;
-    esp_lcd_panel_io_handle_t io;
-    int reset_gpio_num;
-    int x_gap;
-    int y_gap;
-    uint8_t madctl;
-    bool invert_color;
-} ili9486_panel_t;
+#define ILI9486_COLMOD_RGB565 0x55
+#define ILI9486_COLMOD_RGB666 0x66
 
-#define LCD_H_RES 320
-#define CONV_BUF_PIXELS (LCD_H_RES * 80)
-static uint8_t s_conv_buf[CONV_BUF_PIXELS * 3];
+// RESX low time (datasheet minimum 10 us), and the wait after it before
+// the first command
+#define ILI9486_RESET_PULSE_US 20
+#define ILI9486_RESET_READY_US 5000
 
-static void rgb565_to_rgb666(const uint16_t *src, uint8_t *dst, size_t pixels)
-{
-
-    
-    for (size_t i = 0; i < pixels; i++) {
-        uint16_t p = src[i];
-        dst[3*i + 0] = ((p >> 11) & 0x1F) << 3;
-        dst[3*i + 1] = ((p >> 5)  & 0x3F) << 2;
-        dst[3*i + 2] = ( p        & 0x1F) << 3;
-    }
-}
+#define ILI9486_MADCTL_MY    0x80
+#define ILI9486_MADCTL_MX    0x40
+#define ILI9486_MADCTL_MV    0x20
+#define ILI9486_MADCTL_ORDER (ILI9486_MADCTL_MY | ILI9486_MADCTL_MX | ILI9486_MADCTL_MV)
 
 static esp_err_t panel_ili9486_del(esp_lcd_panel_t *panel);
 static esp_err_t panel_ili9486_reset(esp_lcd_panel_t *panel);
@@ -64,11 +64,155 @@ static esp_err_t panel_ili9486_mirror(esp_lcd_panel_t *panel, bool mx, bool my);
 static esp_err_t panel_ili9486_swap_xy(esp_lcd_panel_t *panel, bool swap);
 static esp_err_t panel_ili9486_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap);
 static esp_err_t panel_ili9486_disp_on_off(esp_lcd_panel_t *panel, bool on);
+static esp_err_t ili9486_frame_add(ili9486_panel_t *ili, const ili9486_region_t *region);
+
+// Flush instrumentation (CONFIG_ILI9486_ENABLE_STATS). Without it every
+// hook below is empty and compiles away.
+
+// A panel IO call returned ret
+static inline void ili9486_stats_io(ili9486_panel_t *ili, int cmd, size_t len, esp_err_t ret)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    if (ret != ESP_OK) {
+        ili->stats.errors++;
+        return;
+    }
+    ili->stats.commands_sent += cmd >= 0;
+    ili->stats.bytes_sent    += len + (cmd >= 0);
+#endif
+}
+
+// A flush of the given size was requested
+static inline void ili9486_stats_flush(ili9486_panel_t *ili, size_t pixels)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili->stats.flushes++;
+#if CONFIG_ILI9486_STATS_HISTOGRAM
+    int i = 0;
+    while (i < ILI9486_FLUSH_HIST_BUCKETS - 1 && pixels >= ((size_t)64 << (2 * i))) {
+        i++;
+    }
+    ili->stats.flush_size_hist[i]++;
+#endif
+#endif
+}
+
+#if CONFIG_ILI9486_ENABLE_STATS
+// The flushing task starts on a flush requested at start_us
+static inline void ili9486_stats_send_begin(ili9486_panel_t *ili, int64_t start_us)
+{
+    ili->stats.flush_start_us   = start_us;
+    ili->stats.first_tx_pending = true;
+}
+#endif
+
+static inline void ili9486_stats_region_begin(ili9486_panel_t *ili,
+                                              const ili9486_region_t *region)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili9486_stats_send_begin(ili, region->t_draw_us);
+#endif
+}
+
+// A frame counts as one flush, of all its rectangles, requested by end_frame()
+static inline void ili9486_stats_frame_add(ili9486_panel_t *ili, size_t pixels)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili->stats.frame_pixels += pixels;
+#endif
+}
+
+static inline void ili9486_stats_frame_end(ili9486_panel_t *ili)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili9486_stats_flush(ili, ili->stats.frame_pixels);
+    ili9486_stats_send_begin(ili, esp_timer_get_time());
+    ili->stats.frame_pixels = 0;
+#endif
+}
 
-static esp_err_t ili9486_send(esp_lcd_panel_io_handle_t io,
+// The next transfer is the first pixel transfer of a window; only the
+// flush's first one ends its time in the queue.
+static inline void ili9486_stats_first_tx(ili9486_panel_t *ili)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili9486_stats_t *s = &ili->stats;
+    if (!s->first_tx_pending) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    uint32_t us = (uint32_t)(now - s->flush_start_us);
+    s->queue_us_total += us;
+    if (us > s->queue_us_max) {
+        s->queue_us_max = us;
+    }
+    s->wire_start_us    = now;
+    s->first_tx_pending = false;
+#endif
+}
+
+// The last transfer of a flush is done. Runs in ISR context.
+static inline void ili9486_stats_wire_done(ili9486_panel_t *ili)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili9486_stats_t *s = &ili->stats;
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&s->lock);
+    uint32_t us = (uint32_t)(now - s->wire_start_us);
+    s->wire_us_total += us;
+    if (us > s->wire_us_max) {
+        s->wire_us_max = us;
+    }
+    s->wire_flushes++;
+    portEXIT_CRITICAL_ISR(&s->lock);
+#endif
+}
+
+static inline void ili9486_stats_pixels(ili9486_panel_t *ili, size_t pixels)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili->stats.pixels += pixels;
+#endif
+}
+
+// Cycle counter around a conversion: c0 = ili9486_stats_cycles() before,
+// ili9486_stats_conv() after
+static inline uint32_t ili9486_stats_cycles(void)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    return esp_cpu_get_cycle_count();
+#else
+    return 0;
+#endif
+}
+
+static inline void ili9486_stats_conv(ili9486_panel_t *ili, uint32_t c0, size_t pixels)
+{
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili->stats.conv_cycles += (uint32_t)(esp_cpu_get_cycle_count() - c0);
+    ili->stats.conv_pixels += pixels;
+#endif
+}
+
+static esp_err_t ili9486_send(ili9486_panel_t *ili,
                                int cmd, const uint8_t *data, size_t len)
 {
-    return esp_lcd_panel_io_tx_param(io, cmd, data, len);
+    esp_err_t ret = esp_lcd_panel_io_tx_param(ili->io, cmd, data, len);
+    ili9486_stats_io(ili, cmd, len, ret);
+    return ret;
+}
+
+// All colour-phase transfers go through here so that tx_seq matches the
+// number of on_color_trans_done events the IO will raise.
+static esp_err_t ili9486_tx_color(ili9486_panel_t *ili, int cmd,
+                                  const void *data, size_t len)
+{
+    esp_err_t ret = esp_lcd_panel_io_tx_color(ili->io, cmd, data, len);
+    if (ret == ESP_OK) {
+        ili->tx_seq++;
+    }
+    ili9486_stats_io(ili, cmd, len, ret);
+    return ret;
 }
 
 // Send MADCTL specifically.
@@ -77,50 +221,573 @@ static esp_err_t ili9486_send(esp_lcd_panel_io_handle_t io,
 // A single-byte parameter (1 byte < 16 bits) gets dropped or mis-padded,
 // so the MADCTL value never reaches the display.
 //
-// Fix: send the command via tx_param (cmd-only, no data), then send the
-// 1-byte parameter via tx_color which bypasses the 16-bit packing and
-// sends raw bytes — exactly as CASET/RASET coordinate data is handled.
-static esp_err_t ili9486_send_madctl(esp_lcd_panel_io_handle_t io, uint8_t madctl)
+// Fix: send command and 1-byte parameter as one tx_color() transfer,
+// which bypasses the 16-bit packing and sends raw bytes — exactly as
+// CASET/RASET coordinate data is handled. The byte is queued, not copied,
+// so it is sent from ili->madctl rather than from the stack.
+static esp_err_t ili9486_send_madctl(ili9486_panel_t *ili)
 {
-    esp_err_t ret = esp_lcd_panel_io_tx_param(io, ILI9486_CMD_MADCTL, NULL, 0);
-    if (ret != ESP_OK) return ret;
-    return esp_lcd_panel_io_tx_color(io, -1, &madctl, 1);
+    return ili9486_tx_color(ili, ILI9486_CMD_MADCTL, &ili->madctl, 1);
 }
 
-static void ili9486_send_init_sequence(esp_lcd_panel_io_handle_t io, uint8_t madctl)
+// Block until every queued colour transaction on this IO has completed.
+//
+// tx_param() always drains the SPI transaction queue before its polling
+// phase. With cmd=-1 and no parameters nothing is put on the wire, so this
+// is a pure "wait for DMA idle" barrier.
+static esp_err_t ili9486_wait_idle(esp_lcd_panel_io_handle_t io)
 {
-    ili9486_send(io, ILI9486_CMD_SWRESET, NULL, 0);
-    vTaskDelay(pdMS_TO_TICKS(120));
+    return esp_lcd_panel_io_tx_param(io, -1, NULL, 0);
+}
 
-    ili9486_send(io, ILI9486_CMD_SLPOUT, NULL, 0);
-    vTaskDelay(pdMS_TO_TICKS(20));
+// Panel IO colour-done hook, installed only once driver callbacks are
+// registered. Runs in ISR context.
+static bool ili9486_on_color_trans_done(esp_lcd_panel_io_handle_t io,
+                                        esp_lcd_panel_io_event_data_t *edata,
+                                        void *user_ctx)
+{
+    ili9486_panel_t *ili = user_ctx;
+    bool need_yield = false;
+    if (++ili->done_seq != ili->flush_end_seq) {
+        return false;
+    }
+    ili9486_stats_wire_done(ili);
+    if (ili->te.gpio_num >= 0) {
+        ili9486_te_write_done(ili);
+    }
+    // Zero-copy: DMA was reading color_data up to this point
+    if (ili->zero_copy && ili->cbs.on_src_released) {
+        need_yield |= ili->cbs.on_src_released(&ili->base, ili->user_ctx);
+    }
+    if (ili->cbs.on_flush_done) {
+        need_yield |= ili->cbs.on_flush_done(&ili->base, ili->user_ctx);
+    }
+    return need_yield;
+}
+
+// A flush that put nothing on the wire (e.g. the shadow found it all
+// unchanged) raises no wire-done event: report it from the flushing task,
+// once whatever is still on the wire has gone out.
+static void ili9486_flush_done_now(ili9486_panel_t *ili)
+{
+    if (!ili->cbs.on_flush_done) {
+        return;
+    }
+    if (ili->done_seq != ili->tx_seq) {
+        ili9486_wait_idle(ili->io);
+    }
+    ili->cbs.on_flush_done(&ili->base, ili->user_ctx);
+}
+
+// Encode multi-byte command parameters for the module's parameter width:
+// each byte zero-padded to a 16-bit word (default, see README), or as is
+// with flags.params_8bit. dst must hold 2 * n bytes. Returns its length.
+static size_t ili9486_encode_params(const ili9486_panel_t *ili, uint8_t *dst,
+                                    const uint8_t *params, size_t n)
+{
+    if (!ili->pad_params) {
+        memcpy(dst, params, n);
+        return n;
+    }
+    for (size_t i = 0; i < n; i++) {
+        dst[2 * i]     = 0x00;
+        dst[2 * i + 1] = params[i];
+    }
+    return 2 * n;
+}
+
+// Encode a CASET/RASET start/end pair (inclusive end).
+static size_t ili9486_encode_range(const ili9486_panel_t *ili, uint8_t *dst,
+                                   int start, int end)
+{
+    const uint8_t params[4] = {
+        (uint8_t)((start >> 8) & 0xFF), (uint8_t)(start & 0xFF),
+        (uint8_t)((end >> 8) & 0xFF),   (uint8_t)(end & 0xFF),
+    };
+    return ili9486_encode_params(ili, dst, params, sizeof(params));
+}
+
+// Program the GRAM window (panel coordinates, end exclusive), skipping
+// CASET and/or RASET when the panel already holds that range. Every RAMWR
+// restarts at the window origin, so reusing a window is always safe.
+//
+// Each command goes out together with its parameters as a single
+// tx_color() call. The parameter blocks live in the panel struct because
+// tx_color() only queues them; the command phase of the RAMWR that follows
+// drains them before the next call. A range is only cached once its
+// command has been queued.
+static esp_err_t ili9486_set_window(ili9486_panel_t *ili, int x_start, int y_start,
+                                    int x_end, int y_end)
+{
+    ili9486_window_t *win = &ili->win;
+    size_t len;
+
+    if (win->col_valid && win->x_start == x_start && win->x_end == x_end) {
+        win->cmds_skipped++;
+    } else {
+        win->col_valid = false;
+        len = ili9486_encode_range(ili, win->caset, x_start, x_end - 1);
+        ESP_RETURN_ON_ERROR(ili9486_tx_color(ili, ILI9486_CMD_CASET, win->caset, len),
+                            TAG, "send CASET failed");
+        win->col_valid = true;
+        win->x_start   = x_start;
+        win->x_end     = x_end;
+    }
 
-    ili9486_send(io, 0xB0, (uint8_t[]){0x00}, 1);
-    ili9486_send(io, 0xB1, (uint8_t[]){0xB0, 0x11}, 2);
-    ili9486_send(io, 0xB4, (uint8_t[]){0x02}, 1);
-    ili9486_send(io, 0xB6, (uint8_t[]){0x02, 0x22}, 2);
-    ili9486_send(io, 0xB7, (uint8_t[]){0xC6}, 1);
-    ili9486_send(io, 0xC0, (uint8_t[]){0x0D, 0x0D}, 2);
-    ili9486_send(io, 0xC1, (uint8_t[]){0x41}, 1);
-    ili9486_send(io, 0xC5, (uint8_t[]){0x00, 0x18}, 2);
+    if (win->row_valid && win->y_start == y_start && win->y_end == y_end) {
+        win->cmds_skipped++;
+    } else {
+        win->row_valid = false;
+        len = ili9486_encode_range(ili, win->raset, y_start, y_end - 1);
+        ESP_RETURN_ON_ERROR(ili9486_tx_color(ili, ILI9486_CMD_RASET, win->raset, len),
+                            TAG, "send RASET failed");
+        win->row_valid = true;
+        win->y_start   = y_start;
+        win->y_end     = y_end;
+    }
+    return ESP_OK;
+}
 
-    ili9486_send(io, 0xE0,
-        (uint8_t[]){0x0F,0x1F,0x1C,0x0C,0x0F,0x08,0x48,0x98,
-                    0x37,0x0A,0x13,0x04,0x11,0x0D,0x00}, 15);
-    ili9486_send(io, 0xE1,
-        (uint8_t[]){0x0F,0x32,0x2E,0x0B,0x0D,0x05,0x47,0x75,
-                    0x37,0x06,0x10,0x03,0x24,0x20,0x00}, 15);
+// Forget the programmed window: after a reset, or whenever the mapping
+// from caller to panel coordinates changes.
+static void ili9486_invalidate_window(ili9486_panel_t *ili)
+{
+    ili->win.col_valid = false;
+    ili->win.row_valid = false;
+}
 
-    //ili9486_send(io, ILI9486_CMD_COLMOD, (uint8_t[]){0x66}, 1);
-    esp_lcd_panel_io_tx_param(io, ILI9486_CMD_COLMOD, NULL, 0);
-    esp_lcd_panel_io_tx_color(io, -1, (uint8_t[]){0x66}, 1);
+// Pixel sink for the current window. Pixels are put in GRAM order, from
+// one or more source runs, and sent converted chunk by chunk, so an area
+// of any size is written with a single CASET/RASET setup. The first
+// chunk carries RAMWR as its command phase, which is a polling transfer
+// and so also drains the window setup.
+//
+// Pipelined: tx_color() only queues the pixel data and returns, so the
+// conversion of the next chunk overlaps the DMA of the previous one. The
+// queue is drained before each chunk is queued: at that point the only
+// transaction in flight is the previous chunk, and once it is done the
+// other ping-pong buffer is free to be converted into next. conv_idx
+// carries over between flushes, so this also holds when the window setup
+// was skipped and the previous flush is still on the wire.
+//
+// Single buffer: every band after the first is sent with RAMWRC (0x3C),
+// which continues from where the previous band stopped instead of
+// restarting at the window origin. The queue is drained before each
+// conversion since the band in flight reads the same buffer.
+//
+// Zero-copy: each contiguous source run is queued as a single transfer;
+// the IO splits it to the bus max_transfer_sz and still raises one done
+// event. Runs that follow each other in memory are joined first.
+//
+// A full chunk or run is only sent once more pixels arrive, so that
+// stream_end() knows which transfer is the last one.
+typedef struct {
+    ili9486_panel_t *ili;
+    bool first;                 // the next transfer carries RAMWR
+    size_t fill;                // pixels converted into the current chunk
+    const uint8_t *run;         // zero-copy run not yet queued
+    size_t run_pixels;
+} ili9486_stream_t;
+
+static void ili9486_stream_begin(ili9486_panel_t *ili, ili9486_stream_t *st)
+{
+    *st = (ili9486_stream_t){ .ili = ili, .first = true };
+}
+
+// Queue the chunk or run held by the sink. last: it ends the flush, so
+// it raises the flush-done event.
+static esp_err_t ili9486_stream_send(ili9486_stream_t *st, bool last)
+{
+    ili9486_panel_t *ili = st->ili;
+    const void *data;
+    size_t len;
+    int cmd;
+    esp_err_t ret;
+
+    if (ili->zero_copy) {
+        if (st->run_pixels == 0) return ESP_OK;
+        data = st->run;
+        len  = st->run_pixels * ili->src_bytes_per_pixel;
+        cmd  = st->first ? ILI9486_CMD_RAMWR : -1;
+        st->run_pixels = 0;
+    } else {
+        if (st->fill == 0) return ESP_OK;
+        data = ili->conv_buf[ili->conv_idx];
+        len  = st->fill * 3;
+#if CONFIG_ILI9486_PIPELINED_FLUSH
+        if (st->first) {
+            cmd = ILI9486_CMD_RAMWR;
+        } else {
+            ret = ili9486_wait_idle(ili->io);
+            if (ret != ESP_OK) return ret;
+            cmd = -1;
+        }
+#else
+        cmd = st->first ? ILI9486_CMD_RAMWR : ILI9486_CMD_RAMWRC;
+#endif
+        st->fill      = 0;
+        ili->conv_idx = (ili->conv_idx + 1) % CONV_BUF_COUNT;
+    }
+
+    if (st->first) {
+        ili9486_stats_first_tx(ili);
+    }
+    // Arm the wire-done event before queueing: the ISR may fire before
+    // tx_color() returns. The previous flush must have raised its own
+    // first, or its event would no longer match: when this is the RAMWR
+    // transfer (window setup skipped) its command phase would drain that
+    // flush only after the new end was armed.
+    if (last && ili->done_events && (int32_t)(ili->flush_end_seq - ili->done_seq) > 0) {
+        ret = ili9486_wait_idle(ili->io);
+        if (ret != ESP_OK) return ret;
+    }
+    if (last) {
+        ili->flush_end_seq = ili->tx_seq + 1;
+    }
+    ret = ili9486_tx_color(ili, cmd, data, len);
+    if (ret != ESP_OK) {
+        ili->flush_end_seq = 0;
+        return ret;
+    }
+    st->first = false;
+    return ESP_OK;
+}
+
+static esp_err_t ili9486_stream_put(ili9486_stream_t *st, const void *color_data,
+                                    size_t pixels)
+{
+    ili9486_panel_t *ili = st->ili;
+    esp_err_t ret;
+
+    ili9486_stats_pixels(ili, pixels);
+    if (ili->zero_copy) {
+        const uint8_t *src = color_data;
+        if (st->run_pixels && st->run + st->run_pixels * ili->src_bytes_per_pixel == src) {
+            st->run_pixels += pixels;
+            return ESP_OK;
+        }
+        ret = ili9486_stream_send(st, false);
+        if (ret != ESP_OK) return ret;
+        st->run        = src;
+        st->run_pixels = pixels;
+        return ESP_OK;
+    }
+
+    const uint16_t *src = color_data;
+    while (pixels > 0) {
+        if (st->fill == ili->conv_buf_pixels) {
+            ret = ili9486_stream_send(st, false);
+            if (ret != ESP_OK) return ret;
+        }
+#if !CONFIG_ILI9486_PIPELINED_FLUSH
+        if (st->fill == 0) {
+            ret = ili9486_wait_idle(ili->io);
+            if (ret != ESP_OK) return ret;
+        }
+#endif
+        size_t room = ili->conv_buf_pixels - st->fill;
+        size_t n = pixels < room ? pixels : room;
+        uint32_t c0 = ili9486_stats_cycles();
+        ili->conv(src, ili->conv_buf[ili->conv_idx] + st->fill * 3, n);
+        ili9486_stats_conv(ili, c0, n);
+        st->fill += n;
+        src      += n;
+        pixels   -= n;
+    }
+    return ESP_OK;
+}
+
+// Output rows [row, row + rows) of a rotated and/or mirrored RGB565 area,
+// converted by ili9486_rgb565_to_rgb666_xform() straight into the chunk.
+// The rows must fit in one chunk.
+static esp_err_t ili9486_stream_put_xform(ili9486_stream_t *st, const uint16_t *src,
+                                          size_t stride, int width, int height,
+                                          ili9486_xform_t xform, int row, int rows)
+{
+    ili9486_panel_t *ili = st->ili;
+    const size_t pixels = (size_t)rows * ((xform & ILI9486_XFORM_SWAP_XY) ? height : width);
+    esp_err_t ret;
+
+    ili9486_stats_pixels(ili, pixels);
+    if (st->fill + pixels > ili->conv_buf_pixels) {
+        ret = ili9486_stream_send(st, false);
+        if (ret != ESP_OK) return ret;
+    }
+#if !CONFIG_ILI9486_PIPELINED_FLUSH
+    if (st->fill == 0) {
+        ret = ili9486_wait_idle(ili->io);
+        if (ret != ESP_OK) return ret;
+    }
+#endif
+    uint32_t c0 = ili9486_stats_cycles();
+    ili9486_rgb565_to_rgb666_xform(src, stride, width, height, xform, row, rows,
+                                   ili->conv_buf[ili->conv_idx] + st->fill * 3);
+    ili9486_stats_conv(ili, c0, pixels);
+    st->fill += pixels;
+    return ESP_OK;
+}
+
+// last: this window ends the flush
+static esp_err_t ili9486_stream_end(ili9486_stream_t *st, bool last)
+{
+    return ili9486_stream_send(st, last);
+}
+
+static esp_err_t ili9486_stream_pixels(ili9486_panel_t *ili, const void *color_data,
+                                       size_t pixels, bool last)
+{
+    ili9486_stream_t st;
+    ili9486_stream_begin(ili, &st);
+    esp_err_t ret = ili9486_stream_put(&st, color_data, pixels);
+    if (ret == ESP_OK) {
+        ret = ili9486_stream_end(&st, last);
+    }
+    return ret;
+}
+
+// Rows of width pixels, row_bytes apart in src, into the current window
+static esp_err_t ili9486_stream_rows(ili9486_panel_t *ili, const uint8_t *src,
+                                     size_t row_bytes, int width, int rows, bool last)
+{
+    if (row_bytes == (size_t)width * ili->src_bytes_per_pixel) {
+        return ili9486_stream_pixels(ili, src, (size_t)width * rows, last);
+    }
+    ili9486_stream_t st;
+    ili9486_stream_begin(ili, &st);
+    esp_err_t ret = ESP_OK;
+    for (int r = 0; r < rows && ret == ESP_OK; r++) {
+        ret = ili9486_stream_put(&st, src + r * row_bytes, width);
+    }
+    return ret == ESP_OK ? ili9486_stream_end(&st, last) : ret;
+}
+
+// Delays are the datasheet minima: 5 ms after SWRESET before any command
+// but 120 ms before SLPOUT (the panel may have been awake), 5 ms after
+// SLPOUT for the supplies and oscillator to settle. DISPON needs none.
+static const ili9486_lcd_init_cmd_t s_init_cmds[] = {
+    {ILI9486_CMD_SWRESET, 0, 120, NULL},
+    {ILI9486_CMD_SLPOUT, 0, 5, NULL},
+    {0xB0, 1, 0, (const uint8_t[]){0x00}},
+    {0xB1, 2, 0, (const uint8_t[]){0xB0, 0x11}},
+    {0xB4, 1, 0, (const uint8_t[]){0x02}},
+    {0xB6, 2, 0, (const uint8_t[]){0x02, 0x22}},
+    {0xB7, 1, 0, (const uint8_t[]){0xC6}},
+    {0xC0, 2, 0, (const uint8_t[]){0x0D, 0x0D}},
+    {0xC1, 1, 0, (const uint8_t[]){0x41}},
+    {0xC5, 2, 0, (const uint8_t[]){0x00, 0x18}},
+    {0xE0, 15, 0, (const uint8_t[]){0x0F,0x1F,0x1C,0x0C,0x0F,0x08,0x48,0x98,
+                                    0x37,0x0A,0x13,0x04,0x11,0x0D,0x00}},
+    {0xE1, 15, 0, (const uint8_t[]){0x0F,0x32,0x2E,0x0B,0x0D,0x05,0x47,0x75,
+                                    0x37,0x06,0x10,0x03,0x24,0x20,0x00}},
+};
+
+// Rows per splash chunk. Two chunks are used: one is on the wire while
+// the other is decoded into.
+#define SPLASH_CHUNK_ROWS 4
+
+// RGB666 wire pixels in place from R, G, B to the B, G, R order that
+// RGB888 input is sent in
+static void ili9486_swap_rb(uint8_t *px, size_t pixels)
+{
+    for (size_t i = 0; i < pixels; i++, px += 3) {
+        uint8_t r = px[0];
+        px[0] = px[2];
+        px[2] = r;
+    }
+}
+
+// One RGB565 colour in the panel's wire format; returns its size
+static size_t ili9486_wire_pixel(const ili9486_panel_t *ili, uint16_t color, uint8_t px[3])
+{
+    if (ili->colmod == ILI9486_COLMOD_RGB565) {
+        px[0] = color >> 8;
+        px[1] = color & 0xFF;
+        return 2;
+    }
+    ili9486_rgb565_to_rgb666_ref(&color, px, 1);
+    if (ili->swap_rb) {
+        ili9486_swap_rb(px, 1);
+    }
+    return 3;
+}
+
+// Write the vendor splash over the whole GRAM, centred on its background
+static esp_err_t ili9486_send_splash(ili9486_panel_t *ili)
+{
+    ili9486_splash_t s;
+    ESP_RETURN_ON_ERROR(ili9486_splash_open(&s, ili->splash, ili->splash_size), TAG,
+                        "bad splash image");
+
+    const int w = ili->width;
+    const int h = ili->height;
+    const bool native = ili->colmod == ILI9486_COLMOD_RGB565;
+    const size_t px_bytes = native ? 2 : 3;
+    const size_t chunk_bytes = (size_t)w * SPLASH_CHUNK_ROWS * px_bytes;
+
+    // Two wire-format chunks, then one decoded row
+    uint8_t *buf = heap_caps_malloc(2 * chunk_bytes + w * sizeof(uint16_t),
+                                    MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    ESP_RETURN_ON_FALSE(buf, ESP_ERR_NO_MEM, TAG, "no memory for splash chunks");
+    uint16_t *row = (uint16_t *)(buf + 2 * chunk_bytes);
+
+    // Image placement on screen; negative offsets crop it
+    const int ox = (w - s.width) / 2;
+    const int oy = (h - s.height) / 2;
+    const int x0 = MAX(ox, 0);
+    const int x1 = MIN(ox + s.width, w);
+
+    esp_err_t ret = ili9486_set_window(ili, 0, 0, w, h);
+    if (ret == ESP_OK) {
+        ret = ili9486_splash_read(&s, NULL, (size_t)MAX(-oy, 0) * s.width);
+    }
+    int chunk = 0;
+    size_t fill = 0;
+    bool row_blank = false;
+    for (int y = 0; y < h && ret == ESP_OK; y++) {
+        int iy = y - oy;
+        if (iy >= 0 && iy < s.height) {
+            for (int x = 0; x < x0; x++) row[x] = s.background;
+            for (int x = x1; x < w; x++) row[x] = s.background;
+            ret = ili9486_splash_read(&s, NULL, MAX(-ox, 0));
+            if (ret == ESP_OK) ret = ili9486_splash_read(&s, row + x0, x1 - x0);
+            if (ret == ESP_OK) ret = ili9486_splash_read(&s, NULL, ox + s.width - x1);
+            if (ret != ESP_OK) break;
+            row_blank = false;
+        } else if (!row_blank) {
+            for (int x = 0; x < w; x++) row[x] = s.background;
+            row_blank = true;
+        }
+
+        uint8_t *dst = buf + chunk * chunk_bytes + fill;
+        if (native) {
+            for (int x = 0; x < w; x++) {
+                dst[2 * x]     = row[x] >> 8;
+                dst[2 * x + 1] = row[x] & 0xFF;
+            }
+        } else {
+            ili->conv(row, dst, w);
+            if (ili->swap_rb) {
+                ili9486_swap_rb(dst, w);
+            }
+        }
+        fill += (size_t)w * px_bytes;
+
+        if (fill == chunk_bytes || y == h - 1) {
+            // The other chunk is the only transfer in flight; once it is
+            // done that buffer is free to decode into next
+            if (y >= SPLASH_CHUNK_ROWS) {
+                ret = ili9486_wait_idle(ili->io);
+                if (ret != ESP_OK) break;
+            }
+            ret = ili9486_tx_color(ili, y < SPLASH_CHUNK_ROWS ? ILI9486_CMD_RAMWR : -1,
+                                   buf + chunk * chunk_bytes, fill);
+            chunk ^= 1;
+            fill   = 0;
+        }
+    }
+
+    esp_err_t idle = ili9486_wait_idle(ili->io);
+    heap_caps_free(buf);
+    return ret == ESP_OK ? idle : ret;
+}
+
+// The commands that follow the table, built from the panel state
+static esp_err_t ili9486_send_init_tail(ili9486_panel_t *ili)
+{
+    // Same tx_color workaround as MADCTL, sent from ili->colmod for the
+    // same lifetime reason.
+    ESP_RETURN_ON_ERROR(ili9486_tx_color(ili, ILI9486_CMD_COLMOD, &ili->colmod, 1), TAG,
+                        "send COLMOD failed");
 
     // Send MADCTL via tx_color to bypass lcd_param_bits=16 word-packing,
     // which drops single-byte parameters.
-    ili9486_send_madctl(io, madctl);
+    ESP_RETURN_ON_ERROR(ili9486_send_madctl(ili), TAG, "send MADCTL failed");
+
+    // TE output, V-blank pulses only (M=0)
+    if (ili->te.gpio_num >= 0) {
+        ili->te.teon_param = 0x00;
+        ESP_RETURN_ON_ERROR(ili9486_tx_color(ili, ILI9486_CMD_TEON, &ili->te.teon_param, 1),
+                            TAG, "send TEON failed");
+    }
+
+    if (ili->splash) {
+        ESP_RETURN_ON_ERROR(ili9486_send_splash(ili), TAG, "splash failed");
+    }
+    return ili9486_send(ili, ILI9486_CMD_DISPON, NULL, 0);
+}
+
+// Sleep for about us: whole ticks, or a busy wait for less than one.
+// init_poll() checks the deadline again afterwards.
+static void ili9486_sleep_us(uint32_t us)
+{
+    const uint32_t tick_us = portTICK_PERIOD_MS * 1000;
+    if (us >= tick_us) {
+        vTaskDelay(us / tick_us);
+    } else {
+        esp_rom_delay_us(us);
+    }
+}
+
+// Allocate the per-panel conversion buffer(s) from DMA-capable memory.
+static esp_err_t ili9486_alloc_conv_bufs(ili9486_panel_t *ili,
+                                         const ili9486_vendor_config_t *vcfg)
+{
+    size_t pixels = (vcfg && vcfg->conv_buf_pixels) ? vcfg->conv_buf_pixels
+                                                    : CONV_BUF_DEFAULT_PIXELS;
+    uint32_t caps = MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL;
+    if (vcfg && vcfg->flags.conv_buf_in_psram) {
+#if SOC_PSRAM_DMA_CAPABLE
+        caps = MALLOC_CAP_DMA | MALLOC_CAP_SPIRAM;
+#else
+        ESP_LOGW(TAG, "PSRAM is not DMA capable on this target, using internal RAM");
+#endif
+    }
+
+    for (int i = 0; i < CONV_BUF_COUNT; i++) {
+        ili->conv_buf[i] = heap_caps_aligned_calloc(CONV_BUF_ALIGN, 1, pixels * 3, caps);
+        ESP_RETURN_ON_FALSE(ili->conv_buf[i], ESP_ERR_NO_MEM, TAG,
+                            "no memory for conversion buffer (%u bytes)",
+                            (unsigned)(pixels * 3));
+    }
+    ili->conv_buf_pixels = pixels;
+    return ESP_OK;
+}
+
+static void ili9486_free_conv_bufs(ili9486_panel_t *ili)
+{
+    for (int i = 0; i < CONV_BUF_COUNT; i++) {
+        heap_caps_free(ili->conv_buf[i]);
+        ili->conv_buf[i] = NULL;
+    }
+}
+
+static esp_err_t ili9486_coalesce_config(ili9486_panel_t *ili,
+                                         const ili9486_vendor_config_t *vcfg)
+{
+    ili9486_coalesce_t *c = &ili->coalesce;
+    c->max_rects   = COALESCE_DEFAULT_RECTS;
+    c->setup_bytes = COALESCE_SETUP_BYTES;
+    c->span_bytes  = ili->zero_copy ? COALESCE_SPAN_BYTES_ZC : COALESCE_SPAN_BYTES;
+    c->wire_bytes_per_pixel = (ili->colmod == ILI9486_COLMOD_RGB565) ? 2 : 3;
+    if (vcfg) {
+        ESP_RETURN_ON_FALSE(vcfg->coalesce.max_rects <= COALESCE_MAX_RECTS, ESP_ERR_INVALID_ARG,
+                            TAG, "coalesce.max_rects above %d", COALESCE_MAX_RECTS);
+        if (vcfg->coalesce.max_rects) c->max_rects = vcfg->coalesce.max_rects;
+        if (vcfg->coalesce.setup_bytes) c->setup_bytes = vcfg->coalesce.setup_bytes;
+        if (vcfg->coalesce.span_bytes) c->span_bytes = vcfg->coalesce.span_bytes;
+    }
+    return ESP_OK;
+}
 
-    ili9486_send(io, ILI9486_CMD_DISPON, NULL, 0);
-    vTaskDelay(pdMS_TO_TICKS(20));
+static void ili9486_coalesce_free(ili9486_panel_t *ili)
+{
+    ili9486_coalesce_t *c = &ili->coalesce;
+    free(c->rects);
+    free(c->groups);
+    free(c->spans);
+    c->rects  = NULL;
+    c->groups = NULL;
+    c->spans  = NULL;
 }
 
 esp_err_t esp_lcd_new_panel_ili9486(esp_lcd_panel_io_handle_t io,
@@ -129,16 +796,73 @@ esp_err_t esp_lcd_new_panel_ili9486(esp_lcd_panel_io_handle_t io,
 {
     ESP_RETURN_ON_FALSE(io && cfg && ret_panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
 
+    esp_err_t ret = ESP_OK;
+    const ili9486_vendor_config_t *vcfg = cfg->vendor_config;
+
+    ili9486_pixel_format_t fmt = vcfg ? vcfg->pixel_format : ILI9486_PIXEL_FORMAT_RGB666;
+    ESP_RETURN_ON_FALSE(fmt == ILI9486_PIXEL_FORMAT_RGB666 || fmt == ILI9486_PIXEL_FORMAT_RGB565,
+                        ESP_ERR_INVALID_ARG, TAG, "unsupported pixel format %d", fmt);
+    // 16 (or unset): RGB565 input, handled per pixel_format.
+    // 24: RGB888 input, already the RGB666 wire format (the panel ignores
+    // the low 2 bits of each byte) apart from its B, G, R byte order.
+    int bpp = cfg->bits_per_pixel ? cfg->bits_per_pixel : 16;
+    ESP_RETURN_ON_FALSE(bpp == 16 || bpp == 24, ESP_ERR_INVALID_ARG, TAG,
+                        "unsupported bits_per_pixel %d", bpp);
+    ESP_RETURN_ON_FALSE(bpp == 16 || fmt == ILI9486_PIXEL_FORMAT_RGB666, ESP_ERR_INVALID_ARG,
+                        TAG, "RGB565 pixel format needs bits_per_pixel 16");
+    const bool sw_orientation = vcfg && vcfg->flags.sw_orientation;
+    ESP_RETURN_ON_FALSE(!sw_orientation || (bpp == 16 && fmt == ILI9486_PIXEL_FORMAT_RGB666),
+                        ESP_ERR_INVALID_ARG, TAG, "sw_orientation needs RGB565 input and RGB666");
+
     ili9486_panel_t *ili = heap_caps_calloc(1, sizeof(*ili), MALLOC_CAP_DEFAULT);
     ESP_RETURN_ON_FALSE(ili, ESP_ERR_NO_MEM, TAG, "no memory for panel");
+    // No TE pin until ili9486_te_start(), so that err: leaves GPIO0 alone
+    ili->te.gpio_num = -1;
+
+    // Native RGB565 and RGB888 input need no conversion, hence no
+    // conversion buffers
+    ili->zero_copy           = (fmt == ILI9486_PIXEL_FORMAT_RGB565 || bpp != 16);
+    ili->src_bytes_per_pixel = (bpp == 16) ? 2 : 3;
+    ili->swap_rb             = (bpp == 24);
+    ili->colmod              = (fmt == ILI9486_PIXEL_FORMAT_RGB565) ? ILI9486_COLMOD_RGB565
+                                                                    : ILI9486_COLMOD_RGB666;
+    if (!ili->zero_copy) {
+        ESP_GOTO_ON_ERROR(ili9486_alloc_conv_bufs(ili, vcfg), err, TAG,
+                          "conversion buffer alloc failed");
+    }
+
+    ESP_GOTO_ON_ERROR(ili9486_coalesce_config(ili, vcfg), err, TAG, "invalid coalesce config");
 
     ili->io             = io;
+    ili->pad_params     = !(vcfg && vcfg->flags.params_8bit);
+    ili->conv           = ili9486_conv_select();
     ili->reset_gpio_num = cfg->reset_gpio_num;
+    ili->init_cmds      = s_init_cmds;
+    ili->init_cmds_size = sizeof(s_init_cmds) / sizeof(s_init_cmds[0]);
+    if (vcfg && vcfg->init_cmds) {
+        ili->init_cmds      = vcfg->init_cmds;
+        ili->init_cmds_size = vcfg->init_cmds_size;
+    }
+    if (vcfg && vcfg->splash) {
+        ili9486_splash_t splash;
+        ESP_GOTO_ON_ERROR(ili9486_splash_open(&splash, vcfg->splash, vcfg->splash_size), err,
+                          TAG, "invalid splash image");
+        ili->splash      = vcfg->splash;
+        ili->splash_size = vcfg->splash_size;
+    }
     // 0x48 = MX=1, BGR=1.
     // BGR=1 is required because this panel has Red and Blue physically
     // swapped on the flex cable. Without it, R↔B are swapped.
-    ili->madctl         = 0x08;
+    // RGB888 input is B, G, R in memory, so there BGR=0 does the swap.
+    ili->madctl         = ili->swap_rb ? 0x00 : 0x08;
+    ili->width          = LCD_H_RES;
+    ili->height         = LCD_V_RES;
+    ili->sw_orientation = sw_orientation;
+    ili->sw_xform       = ILI9486_XFORM_NONE;
     ili->invert_color   = false;
+#if CONFIG_ILI9486_ENABLE_STATS
+    portMUX_INITIALIZE(&ili->stats.lock);
+#endif
 
     if (cfg->reset_gpio_num >= 0) {
         gpio_config_t rst_conf = {
@@ -158,13 +882,35 @@ esp_err_t esp_lcd_new_panel_ili9486(esp_lcd_panel_io_handle_t io,
     ili->base.set_gap      = panel_ili9486_set_gap;
     ili->base.disp_on_off  = panel_ili9486_disp_on_off;
 
+    ESP_GOTO_ON_ERROR(ili9486_te_start(ili, vcfg), err, TAG, "TE setup failed");
+    ESP_GOTO_ON_ERROR(ili9486_shadow_init(ili, vcfg), err, TAG, "shadow framebuffer alloc failed");
+#if CONFIG_ILI9486_CONVERTER_TASK
+    ESP_GOTO_ON_ERROR(ili9486_worker_start(ili), err, TAG, "converter task start failed");
+#endif
+
     *ret_panel = &ili->base;
     return ESP_OK;
+
+err:
+    ili9486_te_stop(ili);
+    ili9486_free_conv_bufs(ili);
+    ili9486_coalesce_free(ili);
+    ili9486_shadow_free(ili);
+    free(ili);
+    return ret;
 }
 
 static esp_err_t panel_ili9486_del(esp_lcd_panel_t *panel)
 {
     ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+#if CONFIG_ILI9486_CONVERTER_TASK
+    ili9486_worker_stop(ili);
+#endif
+    ili9486_te_stop(ili);
+    ili9486_free_conv_bufs(ili);
+    ili9486_coalesce_free(ili);
+    ili9486_shadow_free(ili);
+    heap_caps_free(ili->fill_buf);
     free(ili);
     return ESP_OK;
 }
@@ -172,23 +918,129 @@ static esp_err_t panel_ili9486_del(esp_lcd_panel_t *panel)
 static esp_err_t panel_ili9486_reset(esp_lcd_panel_t *panel)
 {
     ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_worker_sync(ili);
+    ili9486_invalidate_window(ili);
+    ili9486_shadow_reset(ili);
+    ili->scroll.active = false;
     if (ili->reset_gpio_num >= 0) {
+        // Nothing waits here: init counts the reset's delays from the end
+        // of the pulse, overlapping them with whatever comes in between
         gpio_set_level(ili->reset_gpio_num, 0);
-        vTaskDelay(pdMS_TO_TICKS(10));
+        esp_rom_delay_us(ILI9486_RESET_PULSE_US);
         gpio_set_level(ili->reset_gpio_num, 1);
-        vTaskDelay(pdMS_TO_TICKS(10));
+        ili->hw_reset_us      = esp_timer_get_time();
+        ili->hw_reset_pending = true;
     }
     return ESP_OK;
 }
 
 static esp_err_t panel_ili9486_init(esp_lcd_panel_t *panel)
 {
+    ESP_RETURN_ON_ERROR(esp_lcd_panel_ili9486_init_begin(panel), TAG, "init start failed");
+    uint32_t wait_us;
+    esp_err_t ret;
+    while ((ret = esp_lcd_panel_ili9486_init_poll(panel, &wait_us)) == ESP_ERR_NOT_FINISHED) {
+        ili9486_sleep_us(wait_us);
+    }
+    return ret;
+}
+
+esp_err_t esp_lcd_panel_ili9486_init_begin(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
     ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
-    ili9486_send_init_sequence(ili->io, ili->madctl);
+    ili9486_worker_sync(ili);
+    ili9486_invalidate_window(ili);
+    ili9486_shadow_reset(ili);
+    ili->scroll.active = false;     // SWRESET restores the full-screen area
+
+    ili9486_init_t *init = &ili->init;
+    init->cmds           = ili->init_cmds;
+    init->count          = ili->init_cmds_size;
+    init->next           = 0;
+    init->after_hw_reset = ili->hw_reset_pending;
+    init->due_us         = init->after_hw_reset ? ili->hw_reset_us + ILI9486_RESET_READY_US : 0;
+    init->batch_len      = 0;
+    init->active         = true;
+    ili->hw_reset_pending = false;
+    return ESP_OK;
+}
+
+// Send one init table entry. Entries with parameters go out as a single
+// tx_color() each, command fused with its encoded parameters like
+// MADCTL, and are only queued: a run of them without delays shares one
+// wait for the bus at its end, instead of a blocking tx_param() apiece.
+// The parameters are encoded into init->batch, which must outlive the
+// queued transfers, so the bus is drained when it fills up or when the
+// entry's delay has to start.
+static esp_err_t ili9486_send_init_cmd(ili9486_panel_t *ili, const ili9486_lcd_init_cmd_t *c)
+{
+    ili9486_init_t *init = &ili->init;
+    size_t len = ili->pad_params ? 2 * c->data_bytes : c->data_bytes;
+    esp_err_t ret;
+
+    if (len == 0 || len > sizeof(init->batch)) {
+        // tx_param() drains the queue first
+        init->batch_len = 0;
+        return ili9486_send(ili, c->cmd, c->data, c->data_bytes);
+    }
+    if (init->batch_len + len > sizeof(init->batch)) {
+        ret = ili9486_wait_idle(ili->io);
+        if (ret != ESP_OK) return ret;
+        init->batch_len = 0;
+    }
+    uint8_t *params = init->batch + init->batch_len;
+    ili9486_encode_params(ili, params, c->data, c->data_bytes);
+    ret = ili9486_tx_color(ili, c->cmd, params, len);
+    if (ret != ESP_OK) return ret;
+    init->batch_len += len;
+
+    if (c->delay_ms) {
+        ret = ili9486_wait_idle(ili->io);
+        init->batch_len = 0;
+        return ret;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_ili9486_init_poll(esp_lcd_panel_handle_t panel, uint32_t *wait_us)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_init_t *init = &ili->init;
+
+    // Commands without a delay go out back to back
+    while (init->active) {
+        int64_t now = esp_timer_get_time();
+        if (now < init->due_us) {
+            if (wait_us) {
+                *wait_us = (uint32_t)(init->due_us - now);
+            }
+            return ESP_ERR_NOT_FINISHED;
+        }
+        if (init->next == init->count) {
+            init->active = false;
+            return ili9486_send_init_tail(ili);
+        }
+
+        const ili9486_lcd_init_cmd_t *c = &init->cmds[init->next++];
+        if (c->cmd == ILI9486_CMD_SWRESET && init->after_hw_reset) {
+            init->due_us = MAX(init->due_us, ili->hw_reset_us + c->delay_ms * 1000LL);
+            continue;
+        }
+        esp_err_t ret = ili9486_send_init_cmd(ili, c);
+        if (ret != ESP_OK) {
+            init->active = false;
+            ESP_LOGE(TAG, "init command 0x%02X failed: %s", c->cmd, esp_err_to_name(ret));
+            return ret;
+        }
+        if (c->delay_ms) {
+            init->due_us = esp_timer_get_time() + c->delay_ms * 1000LL;
+        }
+    }
     return ESP_OK;
 }
 
-static int flush_count = 0;
 static esp_err_t panel_ili9486_draw_bitmap(
     esp_lcd_panel_t *panel,
     int x_start, int y_start,
@@ -196,86 +1048,914 @@ static esp_err_t panel_ili9486_draw_bitmap(
     const void *color_data)
 {
     ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
-    esp_lcd_panel_io_handle_t io = ili->io;
+    const ili9486_region_t region = {
+        .x_start    = x_start,
+        .y_start    = y_start,
+        .x_end      = x_end,
+        .y_end      = y_end,
+        .color_data = color_data,
+        .stride     = x_end - x_start,
+#if CONFIG_ILI9486_ENABLE_STATS || CONFIG_ILI9486_CONVERTER_TASK
+        .t_draw_us  = esp_timer_get_time(),
+#endif
+    };
+    return ili9486_draw_region(ili, &region);
+}
+
+esp_err_t ili9486_draw_region(ili9486_panel_t *ili, const ili9486_region_t *region)
+{
+    // Zero-copy hands color_data to the SPI DMA as is; a buffer it cannot
+    // reach would otherwise be bounced through a transfer-sized malloc
+    ESP_RETURN_ON_FALSE(!ili->zero_copy || esp_ptr_dma_capable(region->color_data) ||
+                        esp_ptr_dma_ext_capable(region->color_data), ESP_ERR_INVALID_ARG, TAG,
+                        "color_data must be DMA-capable in zero-copy mode");
+
+    if (ili->coalesce.open) {
+        return ili9486_frame_add(ili, region);
+    }
+    ili9486_stats_flush(ili, (size_t)MAX(region->x_end - region->x_start, 0) *
+                             MAX(region->y_end - region->y_start, 0));
+#if CONFIG_ILI9486_CONVERTER_TASK
+    ili9486_worker_submit(ili, region);
+    return ESP_OK;
+#else
+    return ili9486_flush_region(ili, region);
+#endif
+}
+
+// Map panel row y (gap applied) to its GRAM line under the current scroll
+// offset. *rows receives how many rows from y, at most max_rows, stay
+// contiguous in GRAM: the run ends where memory wraps inside the scroll
+// area, or where y leaves a fixed area or the scroll area.
+static int ili9486_scroll_map(const ili9486_panel_t *ili, int y, int max_rows, int *rows)
+{
+    const ili9486_scroll_t *s = &ili->scroll;
+    int run = max_rows;
+    int line = y;
+
+    if (s->active) {
+        int top = s->top_fixed;
+        int bottom = top + s->scroll_lines;
+        if (y < top) {
+            run = top - y;
+        } else if (y < bottom) {
+            int pos = (y - top + s->offset) % s->scroll_lines;
+            line = top + pos;
+            run = s->scroll_lines - pos;
+            if (bottom - y < run) run = bottom - y;
+        }
+    }
+    *rows = run < max_rows ? run : max_rows;
+    return line;
+}
+
+// Changed-tile window, fed from the caller's buffer at its row pitch
+typedef struct {
+    int x_start;
+    int x_end;
+    int line_start;
+    int line_end;
+    const uint8_t *src;
+} ili9486_dirty_window_t;
+
+static esp_err_t ili9486_send_dirty_window(ili9486_panel_t *ili, const ili9486_dirty_window_t *w,
+                                           size_t row_bytes, bool last)
+{
+    ESP_RETURN_ON_ERROR(ili9486_set_window(ili, w->x_start, w->line_start, w->x_end,
+                                           w->line_end), TAG, "set window failed");
+    return ili9486_stream_rows(ili, w->src, row_bytes, w->x_end - w->x_start,
+                               w->line_end - w->line_start, last);
+}
+
+// Shadow framebuffer path of flush_region() (panel coordinates): take the
+// area over into the shadow first, then send only the parts of it that
+// fall in changed tiles. Each tile row gives one window per run of
+// changed tiles; runs of the same width in consecutive tile rows are
+// joined into one window. *queued: some pixels were sent.
+static esp_err_t ili9486_flush_changed(ili9486_panel_t *ili, int x_start, int y_start,
+                                       int x_end, int y_end, const uint8_t *src,
+                                       size_t row_bytes, bool *queued)
+{
+    const size_t bpp = ili->src_bytes_per_pixel;
+    int changed = 0;
+
+    *queued = false;
+    for (int y = y_start, rows; y < y_end; y += rows) {
+        int line = ili9486_scroll_map(ili, y, y_end - y, &rows);
+        changed += ili9486_shadow_update(ili, x_start, line, x_end, line + rows,
+                                         src + (y - y_start) * row_bytes, row_bytes);
+    }
+    if (changed == 0) {
+        return ESP_OK;
+    }
+
+    if (ili->te.gpio_num >= 0) {
+        ili9486_te_wait(ili, x_start, y_start, x_end, y_end);
+    }
+
+    // The latest window is held back so the final one can end the flush
+    ili9486_dirty_window_t held = {0};
+    bool have = false;
+    esp_err_t ret = ESP_OK;
+    for (int y = y_start, rows; y < y_end && ret == ESP_OK; y += rows) {
+        int line = ili9486_scroll_map(ili, y, y_end - y, &rows);
+        for (int l = line, l_end; l < line + rows && ret == ESP_OK; l = l_end) {
+            l_end = MIN((l / SHADOW_TILE + 1) * SHADOW_TILE, line + rows);
+            for (int x = x_start, x_run; x < x_end && ret == ESP_OK; x = x_run) {
+                x_run = MIN((x / SHADOW_TILE + 1) * SHADOW_TILE, x_end);
+                if (!ili9486_shadow_dirty(ili, x, l)) {
+                    continue;
+                }
+                while (x_run < x_end && ili9486_shadow_dirty(ili, x_run, l)) {
+                    x_run = MIN(x_run + SHADOW_TILE, x_end);
+                }
+                const ili9486_dirty_window_t w = {
+                    .x_start    = x,
+                    .x_end      = x_run,
+                    .line_start = l,
+                    .line_end   = l_end,
+                    .src        = src + (y + l - line - y_start) * row_bytes +
+                                  (x - x_start) * bpp,
+                };
+                if (have && held.x_start == w.x_start && held.x_end == w.x_end &&
+                    held.line_end == w.line_start &&
+                    held.src + (held.line_end - held.line_start) * row_bytes == w.src) {
+                    held.line_end = w.line_end;
+                    continue;
+                }
+                if (have) {
+                    ret = ili9486_send_dirty_window(ili, &held, row_bytes, false);
+                }
+                held = w;
+                have = true;
+            }
+        }
+    }
+    if (ret == ESP_OK && have) {
+        ret = ili9486_send_dirty_window(ili, &held, row_bytes, true);
+        *queued = ret == ESP_OK;
+    }
+
+    for (int y = y_start, rows; y < y_end; y += rows) {
+        int line = ili9486_scroll_map(ili, y, y_end - y, &rows);
+        ili9486_shadow_clear_dirty(ili, x_start, line, x_end, line + rows);
+    }
+    return ret;
+}
+
+// Whether the shadow can take over an area (panel coordinates)
+static bool ili9486_shadow_covers(const ili9486_panel_t *ili, int x_start, int y_start,
+                                  int x_end, int y_end)
+{
+    const ili9486_shadow_t *s = &ili->shadow;
+    return s->enabled && x_start >= 0 && y_start >= 0 && x_end <= s->cols && y_end <= s->rows;
+}
+
+// Screen area to panel area under the software orientation: the same
+// swap and mirrors sw_xform applies to the pixels
+static void ili9486_sw_map_area(const ili9486_panel_t *ili, int *x_start, int *y_start,
+                                int *x_end, int *y_end)
+{
+    const bool swap = ili->sw_xform & ILI9486_XFORM_SWAP_XY;
+    int x0 = swap ? *y_start : *x_start;
+    int x1 = swap ? *y_end : *x_end;
+    int y0 = swap ? *x_start : *y_start;
+    int y1 = swap ? *x_end : *y_end;
+
+    *x_start = (ili->sw_xform & ILI9486_XFORM_MIRROR_X) ? ili->width - x1 : x0;
+    *x_end   = (ili->sw_xform & ILI9486_XFORM_MIRROR_X) ? ili->width - x0 : x1;
+    *y_start = (ili->sw_xform & ILI9486_XFORM_MIRROR_Y) ? ili->height - y1 : y0;
+    *y_end   = (ili->sw_xform & ILI9486_XFORM_MIRROR_Y) ? ili->height - y0 : y1;
+}
+
+// Software orientation path of flush_region() (panel coordinates). Each
+// window is a strip of whole panel rows no wider than a conversion chunk,
+// usually the whole area; its source is the matching band of the caller's
+// area, read rotated. Scrolling is never active here.
+static esp_err_t ili9486_flush_rotated(ili9486_panel_t *ili, int x_start, int y_start,
+                                       int x_end, int y_end, const ili9486_region_t *region)
+{
+    const ili9486_xform_t xform = ili->sw_xform;
+    const bool swap = xform & ILI9486_XFORM_SWAP_XY;
+    const int src_w = region->x_end - region->x_start;
+    const int src_h = region->y_end - region->y_start;
+    const int out_w = x_end - x_start;
+    const int out_h = y_end - y_start;
+    const int strip = MIN(out_w, (int)ili->conv_buf_pixels);
+    esp_err_t ret = ESP_OK;
 
+    if (out_w <= 0 || out_h <= 0) {
+        return ESP_OK;
+    }
+    if (ili->te.gpio_num >= 0) {
+        ili9486_te_wait(ili, x_start, y_start, x_end, y_end);
+    }
+
+    for (int x = 0; x < out_w && ret == ESP_OK; x += strip) {
+        const int w = MIN(strip, out_w - x);
+        const int band = ili->conv_buf_pixels / w;
+        ret = ili9486_set_window(ili, x_start + x, y_start, x_start + x + w, y_end);
+        if (ret != ESP_OK) {
+            break;
+        }
+        ili9486_shadow_invalidate(ili, x_start + x, y_start, x_start + x + w, y_end);
+
+        // Output columns [x, x + w) are source columns, or source rows
+        // with swap, counted from the far end when mirrored
+        const int first = (xform & ILI9486_XFORM_MIRROR_X) ? (swap ? src_h : src_w) - x - w : x;
+        const uint16_t *src = (const uint16_t *)region->color_data +
+                              (swap ? (size_t)first * region->stride : (size_t)first);
+
+        ili9486_stream_t st;
+        ili9486_stream_begin(ili, &st);
+        for (int row = 0; row < out_h && ret == ESP_OK; row += band) {
+            ret = ili9486_stream_put_xform(&st, src, region->stride, swap ? src_w : w,
+                                           swap ? w : src_h, xform, row, MIN(band, out_h - row));
+        }
+        if (ret == ESP_OK) {
+            ret = ili9486_stream_end(&st, x + w == out_w);
+        }
+    }
+    return ret;
+}
+
+esp_err_t ili9486_flush_region(ili9486_panel_t *ili, const ili9486_region_t *region)
+{
+    int x_start = region->x_start;
+    int y_start = region->y_start;
+    int x_end   = region->x_end;
+    int y_end   = region->y_end;
+
+    if (ili->sw_xform != ILI9486_XFORM_NONE) {
+        ili9486_sw_map_area(ili, &x_start, &y_start, &x_end, &y_end);
+    }
     x_start += ili->x_gap;
     x_end   += ili->x_gap;
     y_start += ili->y_gap;
     y_end   += ili->y_gap;
 
-    uint8_t caset[] = {
-        0x00, (uint8_t)((x_start >> 8) & 0xFF),
-        0x00, (uint8_t)(x_start & 0xFF),
-        0x00, (uint8_t)(((x_end - 1) >> 8) & 0xFF),
-        0x00, (uint8_t)((x_end - 1) & 0xFF),
-    };
-    uint8_t raset[] = {
-        0x00, (uint8_t)((y_start >> 8) & 0xFF),
-        0x00, (uint8_t)(y_start & 0xFF),
-        0x00, (uint8_t)(((y_end - 1) >> 8) & 0xFF),
-        0x00, (uint8_t)((y_end - 1) & 0xFF),
-    };
+    size_t pixels = (x_end - x_start) * (y_end - y_start);
+    ili9486_stats_region_begin(ili, region);
 
-    esp_lcd_panel_io_tx_param(io, ILI9486_CMD_CASET, NULL, 0);
-    esp_lcd_panel_io_tx_color(io, -1, caset, 8);
+    const uint8_t *src = region->color_data;
+    const size_t row_bytes = (size_t)region->stride * ili->src_bytes_per_pixel;
+    esp_err_t ret = ESP_OK;
+    bool queued;
+    if (ili->sw_xform != ILI9486_XFORM_NONE) {
+        ret = ili9486_flush_rotated(ili, x_start, y_start, x_end, y_end, region);
+        queued = ret == ESP_OK && pixels > 0;
+    } else if (ili9486_shadow_covers(ili, x_start, y_start, x_end, y_end)) {
+        ret = ili9486_flush_changed(ili, x_start, y_start, x_end, y_end, src, row_bytes,
+                                    &queued);
+    } else {
+        if (ili->te.gpio_num >= 0) {
+            ili9486_te_wait(ili, x_start, y_start, x_end, y_end);
+        }
 
-    esp_lcd_panel_io_tx_param(io, ILI9486_CMD_RASET, NULL, 0);
-    esp_lcd_panel_io_tx_color(io, -1, raset, 8);
+        // One window per run of rows that stays contiguous in GRAM; a single
+        // window unless the area crosses the scroll wrap or a fixed area.
+        for (int y = y_start, rows; y < y_end && ret == ESP_OK; y += rows) {
+            int line = ili9486_scroll_map(ili, y, y_end - y, &rows);
+            ret = ili9486_set_window(ili, x_start, line, x_end, line + rows);
+            if (ret != ESP_OK) {
+                break;
+            }
+            ili9486_shadow_invalidate(ili, x_start, line, x_end, line + rows);
+            ret = ili9486_stream_rows(ili, src, row_bytes, x_end - x_start, rows,
+                                      y + rows == y_end);
+            src += rows * row_bytes;
+        }
+        queued = ret == ESP_OK && pixels > 0;
+    }
 
-    size_t pixels = (x_end - x_start) * (y_end - y_start);
+    // Every pixel has been converted into driver-owned memory by now, so
+    // the caller may reuse its buffer while the tail is still on the wire.
+    // Zero-copy releases it from the ISR instead, unless nothing was queued.
+    if (!(ili->zero_copy && queued) && ili->cbs.on_src_released) {
+        ili->cbs.on_src_released(&ili->base, ili->user_ctx);
+    }
+    if (ret == ESP_OK && !queued) {
+        ili9486_flush_done_now(ili);
+    }
+    return ret;
+}
+
+// Write one coalesced group as a single window (split only at the scroll
+// wrap), gathering each row from the members that cover it.
+static esp_err_t ili9486_emit_group(ili9486_panel_t *ili, const ili9486_rect_group_t *g,
+                                    bool last)
+{
+    ili9486_coalesce_t *c = &ili->coalesce;
+    int x_start = g->x_start + ili->x_gap;
+    int x_end   = g->x_end + ili->x_gap;
+
+    if (ili->te.gpio_num >= 0) {
+        ili9486_te_wait(ili, x_start, g->y_start + ili->y_gap, x_end, g->y_end + ili->y_gap);
+    }
+
+    esp_err_t ret = ESP_OK;
+    for (int y = g->y_start, rows; y < g->y_end && ret == ESP_OK; y += rows) {
+        int line = ili9486_scroll_map(ili, y + ili->y_gap, g->y_end - y, &rows);
+        ret = ili9486_set_window(ili, x_start, line, x_end, line + rows);
+        if (ret != ESP_OK) {
+            break;
+        }
+        ili9486_shadow_invalidate(ili, x_start, line, x_end, line + rows);
+
+        ili9486_stream_t st;
+        ili9486_stream_begin(ili, &st);
+        for (int row = y; row < y + rows && ret == ESP_OK; row++) {
+            int n = ili9486_coalesce_row(c, g->members, g->x_start, g->x_end, row, c->spans);
+            for (int i = 0; i < n && ret == ESP_OK; i++) {
+                const ili9486_span_t *s = &c->spans[i];
+                const ili9486_region_t *r = &c->rects[s->rect];
+                size_t offset = (size_t)(row - r->y_start) * r->stride +
+                                (s->x_start - r->x_start);
+                ret = ili9486_stream_put(&st, (const uint8_t *)r->color_data +
+                                         offset * ili->src_bytes_per_pixel,
+                                         s->x_end - s->x_start);
+            }
+        }
+        if (ret == ESP_OK) {
+            ret = ili9486_stream_end(&st, last && y + rows == g->y_end);
+        }
+    }
+    return ret;
+}
+
+// Send the rectangles held so far. last: they end the frame.
+static esp_err_t ili9486_frame_emit(ili9486_panel_t *ili, bool last, int *windows)
+{
+    ili9486_coalesce_t *c = &ili->coalesce;
+    int n = c->count ? ili9486_coalesce_plan(c) : 0;
+    esp_err_t ret = ESP_OK;
 
-    if (pixels > CONV_BUF_PIXELS) {
-        ESP_LOGE(TAG, "Flush too large! pixels=%u max=%u",
-                 (unsigned)pixels, (unsigned)CONV_BUF_PIXELS);
-        return ESP_ERR_INVALID_SIZE;
+    for (int i = 0; i < n && ret == ESP_OK; i++) {
+        ret = ili9486_emit_group(ili, &c->groups[i], last && i == n - 1);
     }
+    c->rects_out += n;
+    c->queued    |= n > 0;
+    c->count      = 0;
+    if (windows) {
+        *windows = n;
+    }
+    return ret;
+}
 
-    rgb565_to_rgb666((const uint16_t *)color_data, s_conv_buf, pixels);
+// Hold a draw_bitmap() region for end_frame()
+static esp_err_t ili9486_frame_add(ili9486_panel_t *ili, const ili9486_region_t *region)
+{
+    ili9486_coalesce_t *c = &ili->coalesce;
+    if (region->x_start >= region->x_end || region->y_start >= region->y_end) {
+        return ESP_OK;
+    }
+    if (c->count == c->max_rects) {
+        ESP_RETURN_ON_ERROR(ili9486_frame_emit(ili, false, NULL), TAG, "frame flush failed");
+    }
+    c->rects[c->count++] = *region;
+    c->rects_in++;
+    ili9486_stats_frame_add(ili, (size_t)(region->x_end - region->x_start) *
+                                 (region->y_end - region->y_start));
+    return ESP_OK;
+}
 
+// Operations that must not be reordered before the held rectangles
+static esp_err_t ili9486_frame_flush(ili9486_panel_t *ili)
+{
+    return ili->coalesce.open ? ili9486_frame_emit(ili, false, NULL) : ESP_OK;
+}
 
+esp_err_t esp_lcd_panel_ili9486_begin_frame(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_coalesce_t *c = &ili->coalesce;
+    ESP_RETURN_ON_FALSE(!c->open, ESP_ERR_INVALID_STATE, TAG, "frame already open");
+    // Rectangles are merged by panel rows of their source
+    ESP_RETURN_ON_FALSE(ili->sw_xform == ILI9486_XFORM_NONE, ESP_ERR_INVALID_STATE, TAG,
+                        "frames need ILI9486_ORIENTATION_0 with sw_orientation");
+
+    if (!c->rects) {
+        c->rects  = heap_caps_calloc(c->max_rects, sizeof(c->rects[0]), MALLOC_CAP_DEFAULT);
+        c->groups = heap_caps_calloc(c->max_rects, sizeof(c->groups[0]), MALLOC_CAP_DEFAULT);
+        c->spans  = heap_caps_calloc(2 * c->max_rects + 1, sizeof(c->spans[0]),
+                                     MALLOC_CAP_DEFAULT);
+        if (!c->rects || !c->groups || !c->spans) {
+            ili9486_coalesce_free(ili);
+            ESP_LOGE(TAG, "no memory for frame rectangles");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    // Windows are sent from the calling task; nothing may still be queued
+    // for the converter task
+    ili9486_worker_sync(ili);
+    c->count  = 0;
+    c->queued = false;
+    c->open   = true;
+    return ESP_OK;
+}
 
-    // Log area info
+esp_err_t esp_lcd_panel_ili9486_end_frame(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_coalesce_t *c = &ili->coalesce;
+    ESP_RETURN_ON_FALSE(c->open, ESP_ERR_INVALID_STATE, TAG, "no frame open");
+
+    int windows;
+    ili9486_stats_frame_end(ili);
+    esp_err_t ret = ili9486_frame_emit(ili, true, &windows);
+    c->open = false;
 
-    esp_lcd_panel_io_tx_param(io, ILI9486_CMD_RAMWR, NULL, 0);
-    return esp_lcd_panel_io_tx_color(io, -1, s_conv_buf, pixels * 3);
+    // As for a single flush: converted sources are free now, zero-copy
+    // ones once the last window is off the wire. If the last windows were
+    // sent early, wait for them before releasing.
+    bool queued = ili->zero_copy && ret == ESP_OK && windows > 0;
+    if (!queued && ili->cbs.on_src_released) {
+        if (ili->zero_copy && c->queued) {
+            ili9486_wait_idle(ili->io);
+        }
+        ili->cbs.on_src_released(&ili->base, ili->user_ctx);
+    }
+    if (ret == ESP_OK && windows == 0) {
+        ili9486_flush_done_now(ili);
+    }
+    return ret;
 }
 
 static esp_err_t panel_ili9486_invert_color(esp_lcd_panel_t *panel, bool invert)
 {
     ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_worker_sync(ili);
     int cmd = invert ? ILI9486_CMD_INVON : ILI9486_CMD_INVOFF;
     // Use tx_color for the command byte too, same reason as MADCTL
-    return esp_lcd_panel_io_tx_param(ili->io, cmd, NULL, 0);
+    return ili9486_send(ili, cmd, NULL, 0);
+}
+
+// Row/column order per orientation. The glass of these modules is
+// mirrored against the GRAM column order, so upright portrait is MX.
+// Each step turns the image a further 90 degrees, the way lvgl_port
+// combines swap_xy() and mirror() from that starting point.
+static const uint8_t s_orientation_madctl[] = {
+    [ILI9486_ORIENTATION_0]   = ILI9486_MADCTL_MX,
+    [ILI9486_ORIENTATION_90]  = ILI9486_MADCTL_MY | ILI9486_MADCTL_MX | ILI9486_MADCTL_MV,
+    [ILI9486_ORIENTATION_180] = ILI9486_MADCTL_MY,
+    [ILI9486_ORIENTATION_270] = ILI9486_MADCTL_MV,
+};
+
+// The same turns done by draw_bitmap() with flags.sw_orientation, on top
+// of the ILI9486_ORIENTATION_0 MADCTL: each is the table entry above
+// combined with that of ILI9486_ORIENTATION_0, the mirrors then applied to
+// panel rows and columns.
+static const ili9486_xform_t s_orientation_xform[] = {
+    [ILI9486_ORIENTATION_0]   = ILI9486_XFORM_NONE,
+    [ILI9486_ORIENTATION_90]  = ILI9486_XFORM_SWAP_XY | ILI9486_XFORM_MIRROR_Y,
+    [ILI9486_ORIENTATION_180] = ILI9486_XFORM_MIRROR_X | ILI9486_XFORM_MIRROR_Y,
+    [ILI9486_ORIENTATION_270] = ILI9486_XFORM_SWAP_XY | ILI9486_XFORM_MIRROR_X,
+};
+
+// Program a new MADCTL, BGR included, and drop what was tied to the old
+// mapping: the cached window, the shadow tiles and the logical size. The
+// gaps are offsets of the glass within GRAM, so they follow its axes and
+// swap whenever MV does, whichever call changed it.
+static esp_err_t ili9486_apply_madctl(ili9486_panel_t *ili, uint8_t madctl)
+{
+    if ((madctl ^ ili->madctl) & ILI9486_MADCTL_MV) {
+        int gap    = ili->x_gap;
+        ili->x_gap = ili->y_gap;
+        ili->y_gap = gap;
+    }
+    ili->madctl = madctl;
+    ili->width  = (madctl & ILI9486_MADCTL_MV) ? LCD_V_RES : LCD_H_RES;
+    ili->height = (madctl & ILI9486_MADCTL_MV) ? LCD_H_RES : LCD_V_RES;
+    ili9486_invalidate_window(ili);
+    ili9486_shadow_reset(ili);
+    // Use ili9486_send_madctl to bypass lcd_param_bits=16 word-packing
+    return ili9486_send_madctl(ili);
 }
 
 static esp_err_t panel_ili9486_mirror(esp_lcd_panel_t *panel, bool mx, bool my)
 {
     ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
-    if (mx) ili->madctl |=  0x40; else ili->madctl &= ~0x40;
-    if (my) ili->madctl |=  0x80; else ili->madctl &= ~0x80;
-    // Use ili9486_send_madctl to bypass lcd_param_bits=16 word-packing
-    return ili9486_send_madctl(ili->io, ili->madctl);
+    ili9486_worker_sync(ili);
+    ESP_RETURN_ON_ERROR(ili9486_frame_flush(ili), TAG, "frame flush failed");
+    ESP_RETURN_ON_FALSE(!(ili->scroll.active && my), ESP_ERR_INVALID_STATE, TAG,
+                        "mirror_y not supported while scrolling");
+    uint8_t madctl = ili->madctl & ~(ILI9486_MADCTL_MX | ILI9486_MADCTL_MY);
+    if (mx) madctl |= ILI9486_MADCTL_MX;
+    if (my) madctl |= ILI9486_MADCTL_MY;
+    return ili9486_apply_madctl(ili, madctl);
 }
 
 static esp_err_t panel_ili9486_swap_xy(esp_lcd_panel_t *panel, bool swap)
 {
     ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
-    if (swap) ili->madctl |=  0x20; else ili->madctl &= ~0x20;
-    // Use ili9486_send_madctl to bypass lcd_param_bits=16 word-packing
-    return ili9486_send_madctl(ili->io, ili->madctl);
+    ili9486_worker_sync(ili);
+    ESP_RETURN_ON_ERROR(ili9486_frame_flush(ili), TAG, "frame flush failed");
+    ESP_RETURN_ON_FALSE(!(ili->scroll.active && swap), ESP_ERR_INVALID_STATE, TAG,
+                        "swap_xy not supported while scrolling");
+    uint8_t madctl = ili->madctl & ~ILI9486_MADCTL_MV;
+    if (swap) madctl |= ILI9486_MADCTL_MV;
+    return ili9486_apply_madctl(ili, madctl);
+}
+
+esp_err_t esp_lcd_panel_ili9486_set_orientation(esp_lcd_panel_handle_t panel,
+                                                ili9486_orientation_t orientation)
+{
+    ESP_RETURN_ON_FALSE(panel && orientation >= ILI9486_ORIENTATION_0 &&
+                        orientation <= ILI9486_ORIENTATION_270,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_worker_sync(ili);
+    ESP_RETURN_ON_ERROR(ili9486_frame_flush(ili), TAG, "frame flush failed");
+    if (ili->sw_orientation) {
+        ESP_RETURN_ON_FALSE(orientation == ILI9486_ORIENTATION_0 ||
+                            !(ili->scroll.active || ili->coalesce.open),
+                            ESP_ERR_INVALID_STATE, TAG,
+                            "orientation %d not supported while scrolling or in a frame",
+                            (int)orientation);
+        // MADCTL keeps, or returns to, the upright mapping
+        ili->sw_xform = s_orientation_xform[orientation];
+        orientation   = ILI9486_ORIENTATION_0;
+    }
+    uint8_t madctl = (ili->madctl & ~ILI9486_MADCTL_ORDER) | s_orientation_madctl[orientation];
+    ESP_RETURN_ON_FALSE(!(ili->scroll.active &&
+                          (madctl & (ILI9486_MADCTL_MV | ILI9486_MADCTL_MY))),
+                        ESP_ERR_INVALID_STATE, TAG, "orientation %d not supported while scrolling",
+                        (int)orientation);
+    return ili9486_apply_madctl(ili, madctl);
 }
 
 static esp_err_t panel_ili9486_set_gap(esp_lcd_panel_t *panel, int x_gap, int y_gap)
 {
     ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_worker_sync(ili);
+    ESP_RETURN_ON_ERROR(ili9486_frame_flush(ili), TAG, "frame flush failed");
     ili->x_gap = x_gap;
     ili->y_gap = y_gap;
+    ili9486_invalidate_window(ili);
     return ESP_OK;
 }
 
 static esp_err_t panel_ili9486_disp_on_off(esp_lcd_panel_t *panel, bool on)
 {
     ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_worker_sync(ili);
     int cmd = on ? ILI9486_CMD_DISPON : 0x28;
-    return esp_lcd_panel_io_tx_param(ili->io, cmd, NULL, 0);
-}
\ No newline at end of file
+    return ili9486_send(ili, cmd, NULL, 0);
+}
+
+esp_err_t esp_lcd_panel_ili9486_scroll_define(esp_lcd_panel_handle_t panel,
+                                              int top_fixed, int bottom_fixed)
+{
+    ESP_RETURN_ON_FALSE(panel && top_fixed >= 0 && bottom_fixed >= 0 &&
+                        top_fixed + bottom_fixed < LCD_V_RES,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_worker_sync(ili);
+    ESP_RETURN_ON_ERROR(ili9486_frame_flush(ili), TAG, "frame flush failed");
+    ESP_RETURN_ON_FALSE(!(ili->madctl & (ILI9486_MADCTL_MV | ILI9486_MADCTL_MY)) &&
+                        ili->sw_xform == ILI9486_XFORM_NONE,
+                        ESP_ERR_INVALID_STATE, TAG,
+                        "scrolling needs the default row order (no swap_xy / mirror_y)");
+
+    ili9486_scroll_t *s = &ili->scroll;
+    int scroll_lines = LCD_V_RES - top_fixed - bottom_fixed;
+    const uint8_t params[6] = {
+        (uint8_t)(top_fixed >> 8),    (uint8_t)(top_fixed & 0xFF),
+        (uint8_t)(scroll_lines >> 8), (uint8_t)(scroll_lines & 0xFF),
+        (uint8_t)(bottom_fixed >> 8), (uint8_t)(bottom_fixed & 0xFF),
+    };
+    // The parameter blocks may still be queued from a previous call
+    ESP_RETURN_ON_ERROR(ili9486_wait_idle(ili->io), TAG, "wait idle failed");
+    size_t len = ili9486_encode_params(ili, s->vscrdef, params, sizeof(params));
+    ESP_RETURN_ON_ERROR(ili9486_tx_color(ili, ILI9486_CMD_VSCRDEF, s->vscrdef, len),
+                        TAG, "send VSCRDEF failed");
+
+    s->active       = true;
+    s->top_fixed    = top_fixed;
+    s->scroll_lines = scroll_lines;
+    s->offset       = 0;
+    len = ili9486_encode_params(ili, s->vscrsadd,
+                                (uint8_t[]){top_fixed >> 8, top_fixed & 0xFF}, 2);
+    return ili9486_tx_color(ili, ILI9486_CMD_VSCRSADD, s->vscrsadd, len);
+}
+
+esp_err_t esp_lcd_panel_ili9486_scroll_to(esp_lcd_panel_handle_t panel, int offset)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_scroll_t *s = &ili->scroll;
+    ESP_RETURN_ON_FALSE(s->active, ESP_ERR_INVALID_STATE, TAG, "no scroll area defined");
+    ESP_RETURN_ON_FALSE(offset >= 0 && offset < s->scroll_lines, ESP_ERR_INVALID_ARG,
+                        TAG, "offset out of range");
+
+    // Regions already queued were mapped with the old offset
+    ili9486_worker_sync(ili);
+    ESP_RETURN_ON_ERROR(ili9486_frame_flush(ili), TAG, "frame flush failed");
+    ESP_RETURN_ON_ERROR(ili9486_wait_idle(ili->io), TAG, "wait idle failed");
+    int line = s->top_fixed + offset;
+    size_t len = ili9486_encode_params(ili, s->vscrsadd,
+                                       (uint8_t[]){line >> 8, line & 0xFF}, 2);
+    ESP_RETURN_ON_ERROR(ili9486_tx_color(ili, ILI9486_CMD_VSCRSADD, s->vscrsadd, len),
+                        TAG, "send VSCRSADD failed");
+    s->offset = offset;
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_ili9486_scroll_stop(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_worker_sync(ili);
+    ESP_RETURN_ON_ERROR(ili9486_frame_flush(ili), TAG, "frame flush failed");
+    // Normal display mode ends vertical scroll mode
+    ESP_RETURN_ON_ERROR(ili9486_send(ili, ILI9486_CMD_NORON, NULL, 0),
+                        TAG, "send NORON failed");
+    ili->scroll.active = false;
+    return ESP_OK;
+}
+
+static esp_err_t ili9486_alloc_fill_buf(ili9486_panel_t *ili)
+{
+    if (!ili->fill_buf) {
+        ili->fill_buf = heap_caps_aligned_calloc(CONV_BUF_ALIGN, 1, FILL_BUF_PIXELS * 3,
+                                                 MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    }
+    return ili->fill_buf ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_lcd_panel_ili9486_fill_rect(esp_lcd_panel_handle_t panel,
+                                          int x_start, int y_start,
+                                          int x_end, int y_end,
+                                          uint16_t color)
+{
+    ESP_RETURN_ON_FALSE(panel && x_start < x_end && y_start < y_end,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    ili9486_worker_sync(ili);
+    ESP_RETURN_ON_ERROR(ili9486_frame_flush(ili), TAG, "frame flush failed");
+
+    // The previous fill may still be sending from the pattern
+    ESP_RETURN_ON_ERROR(ili9486_wait_idle(ili->io), TAG, "wait idle failed");
+    ESP_RETURN_ON_ERROR(ili9486_alloc_fill_buf(ili), TAG, "no memory for fill pattern");
+
+    // One pixel in wire format, repeated across the pattern
+    uint8_t px[3];
+    const size_t px_bytes = ili9486_wire_pixel(ili, color, px);
+    for (size_t i = 0; i < FILL_BUF_PIXELS; i++) {
+        memcpy(ili->fill_buf + i * px_bytes, px, px_bytes);
+    }
+
+    if (ili->sw_xform != ILI9486_XFORM_NONE) {
+        ili9486_sw_map_area(ili, &x_start, &y_start, &x_end, &y_end);
+    }
+    x_start += ili->x_gap;
+    x_end   += ili->x_gap;
+    y_start += ili->y_gap;
+    y_end   += ili->y_gap;
+
+    if (ili->te.gpio_num >= 0) {
+        ili9486_te_wait(ili, x_start, y_start, x_end, y_end);
+    }
+
+    for (int y = y_start, rows; y < y_end; y += rows) {
+        int line = ili9486_scroll_map(ili, y, y_end - y, &rows);
+        ESP_RETURN_ON_ERROR(ili9486_set_window(ili, x_start, line, x_end, line + rows),
+                            TAG, "set window failed");
+        ili9486_shadow_invalidate(ili, x_start, line, x_end, line + rows);
+
+        // Consecutive data transfers continue where the previous one
+        // stopped, so only the first needs RAMWR.
+        size_t pixels = (size_t)(x_end - x_start) * rows;
+        int cmd = ILI9486_CMD_RAMWR;
+        ili9486_stats_pixels(ili, pixels);
+        while (pixels > 0) {
+            size_t n = pixels < FILL_BUF_PIXELS ? pixels : FILL_BUF_PIXELS;
+            ESP_RETURN_ON_ERROR(ili9486_tx_color(ili, cmd, ili->fill_buf, n * px_bytes),
+                                TAG, "send fill failed");
+            cmd     = -1;
+            pixels -= n;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_ili9486_palette_init(esp_lcd_panel_handle_t panel,
+                                             const uint16_t *colors, size_t count,
+                                             ili9486_palette_t *palette)
+{
+    ESP_RETURN_ON_FALSE(panel && colors && palette && count > 0 && count <= 256,
+                        ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    for (size_t i = 0; i < 256; i++) {
+        uint8_t px[3] = {0};
+        palette->bytes_per_pixel = ili9486_wire_pixel(ili, i < count ? colors[i] : 0, px);
+        palette->entries[i] = px[0] | px[1] << 8 | (uint32_t)px[2] << 16;
+    }
+    return ESP_OK;
+}
+
+// Indices are expanded into the fill pattern buffer, used as two halves:
+// one is expanded into while the other is on the wire.
+esp_err_t esp_lcd_panel_ili9486_draw_indexed(esp_lcd_panel_handle_t panel,
+                                             int x_start, int y_start,
+                                             int x_end, int y_end,
+                                             const void *indices, int bits_per_index,
+                                             const ili9486_palette_t *palette)
+{
+    const int bits = bits_per_index;
+    ESP_RETURN_ON_FALSE(panel && indices && palette && x_start < x_end && y_start < y_end &&
+                        (bits == 1 || bits == 2 || bits == 4 || bits == 8),
+                        ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    const size_t px_bytes = ili->colmod == ILI9486_COLMOD_RGB565 ? 2 : 3;
+    ESP_RETURN_ON_FALSE(palette->bytes_per_pixel == px_bytes, ESP_ERR_INVALID_ARG, TAG,
+                        "palette made for another pixel format");
+    ESP_RETURN_ON_FALSE(ili->sw_xform == ILI9486_XFORM_NONE, ESP_ERR_INVALID_STATE, TAG,
+                        "indexed draws need ILI9486_ORIENTATION_0 with sw_orientation");
+    ili9486_worker_sync(ili);
+    ESP_RETURN_ON_ERROR(ili9486_frame_flush(ili), TAG, "frame flush failed");
+
+    // A fill or the previous indexed draw may still be sending from it
+    ESP_RETURN_ON_ERROR(ili9486_wait_idle(ili->io), TAG, "wait idle failed");
+    ESP_RETURN_ON_ERROR(ili9486_alloc_fill_buf(ili), TAG, "no memory for index expansion");
+
+    const int width = x_end - x_start;
+    const size_t row_bytes = ((size_t)width * bits + 7) / 8;
+    const size_t half = FILL_BUF_PIXELS / 2;
+    const uint8_t *src = indices;
+
+    x_start += ili->x_gap;
+    x_end   += ili->x_gap;
+    y_start += ili->y_gap;
+    y_end   += ili->y_gap;
+
+    if (ili->te.gpio_num >= 0) {
+        ili9486_te_wait(ili, x_start, y_start, x_end, y_end);
+    }
+
+    int k = 0;
+    for (int y = y_start, rows; y < y_end; y += rows) {
+        int line = ili9486_scroll_map(ili, y, y_end - y, &rows);
+        ESP_RETURN_ON_ERROR(ili9486_set_window(ili, x_start, line, x_end, line + rows),
+                            TAG, "set window failed");
+        ili9486_shadow_invalidate(ili, x_start, line, x_end, line + rows);
+        ili9486_stats_pixels(ili, (size_t)width * rows);
+
+        int cmd = ILI9486_CMD_RAMWR;
+        size_t fill = 0;
+        for (int r = y; r < y + rows; r++) {
+            for (int x = 0; x < width; ) {
+                size_t n = MIN((size_t)(width - x), half - fill);
+                uint8_t *dst = ili->fill_buf + (k * half + fill) * px_bytes;
+                ili9486_index_to_wire(src + (size_t)(r - y_start) * row_bytes, x, bits,
+                                      palette->entries, px_bytes, dst, n);
+                fill += n;
+                x    += n;
+                if (fill == half || (r == y + rows - 1 && x == width)) {
+                    // Drains the other half before this one is queued
+                    ESP_RETURN_ON_ERROR(ili9486_wait_idle(ili->io), TAG, "wait idle failed");
+                    ESP_RETURN_ON_ERROR(ili9486_tx_color(ili, cmd, ili->fill_buf +
+                                                         k * half * px_bytes, fill * px_bytes),
+                                        TAG, "send indexed pixels failed");
+                    cmd  = -1;
+                    fill = 0;
+                    k   ^= 1;
+                }
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_ili9486_register_event_callbacks(
+    esp_lcd_panel_handle_t panel,
+    const esp_lcd_panel_ili9486_callbacks_t *cbs,
+    void *user_ctx)
+{
+    ESP_RETURN_ON_FALSE(panel && cbs, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+
+    // Nothing may be in flight while the sequence counters are realigned
+    ili9486_worker_sync(ili);
+    ESP_RETURN_ON_ERROR(ili9486_wait_idle(ili->io), TAG, "wait idle failed");
+    ili->cbs           = *cbs;
+    ili->user_ctx      = user_ctx;
+    ili->done_seq      = ili->tx_seq;
+    ili->flush_end_seq = ili->tx_seq;
+    ili->done_events   = true;
+
+    const esp_lcd_panel_io_callbacks_t io_cbs = {
+        .on_color_trans_done = ili9486_on_color_trans_done,
+    };
+    return esp_lcd_panel_io_register_event_callbacks(ili->io, &io_cbs, ili);
+}
+
+esp_err_t esp_lcd_panel_ili9486_get_stats(esp_lcd_panel_handle_t panel,
+                                          esp_lcd_panel_ili9486_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(panel && stats, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    memset(stats, 0, sizeof(*stats));
+#if CONFIG_ILI9486_CONVERTER_TASK
+    ili9486_worker_t *w = &ili->worker;
+    stats->queue_depth       = w->size;
+    stats->queue_used        = atomic_load(&w->head) - atomic_load(&w->tail);
+    stats->queue_high_water  = w->high_water;
+    stats->queue_full_stalls = w->full_stalls;
+    stats->regions_submitted = w->submitted;
+#endif
+    stats->window_cmds_skipped = ili->win.cmds_skipped;
+    stats->coalesce_rects_in    = ili->coalesce.rects_in;
+    stats->coalesce_rects_out   = ili->coalesce.rects_out;
+    stats->coalesce_bytes_saved = ili->coalesce.bytes_saved;
+    stats->shadow_tiles_checked   = ili->shadow.tiles_checked;
+    stats->shadow_tiles_unchanged = ili->shadow.tiles_unchanged;
+    stats->shadow_bytes_skipped   = ili->shadow.bytes_skipped;
+
+    ili9486_te_t *te = &ili->te;
+    if (te->gpio_num >= 0) {
+        portENTER_CRITICAL(&te->lock);
+        stats->te_frames             = te->frames;
+        stats->te_frame_period_us    = te->period_us;
+        stats->te_wait_us_last_frame = te->wait_us_last_frame;
+        portEXIT_CRITICAL(&te->lock);
+        stats->te_waits           = te->waits;
+        stats->te_timeouts        = te->timeouts;
+        stats->te_chase_fallbacks = te->chase_fallbacks;
+        stats->te_wait_us_max     = te->wait_us_max;
+        stats->te_wait_us_total   = te->wait_us_total;
+    }
+
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili9486_stats_t *s = &ili->stats;
+    stats->flushes        = s->flushes;
+    stats->errors         = s->errors;
+    stats->pixels         = s->pixels;
+    stats->bytes_sent     = s->bytes_sent;
+    stats->commands_sent  = s->commands_sent;
+    stats->conv_pixels    = s->conv_pixels;
+    stats->conv_cycles    = s->conv_cycles;
+    stats->queue_us_total = s->queue_us_total;
+    stats->queue_us_max   = s->queue_us_max;
+    portENTER_CRITICAL(&s->lock);
+    stats->wire_us_total  = s->wire_us_total;
+    stats->wire_us_max    = s->wire_us_max;
+    stats->wire_flushes   = s->wire_flushes;
+    portEXIT_CRITICAL(&s->lock);
+#if CONFIG_ILI9486_STATS_HISTOGRAM
+    memcpy(stats->flush_size_hist, s->flush_size_hist, sizeof(stats->flush_size_hist));
+#endif
+#endif
+    return ESP_OK;
+}
+
+esp_err_t esp_lcd_panel_ili9486_reset_stats(esp_lcd_panel_handle_t panel)
+{
+    ESP_RETURN_ON_FALSE(panel, ESP_ERR_INVALID_ARG, TAG, "invalid arg");
+    ili9486_panel_t *ili = __containerof(panel, ili9486_panel_t, base);
+    // The converter task updates most of them
+    ili9486_worker_sync(ili);
+
+#if CONFIG_ILI9486_CONVERTER_TASK
+    ili9486_worker_t *w = &ili->worker;
+    w->high_water  = atomic_load(&w->head) - atomic_load(&w->tail);
+    w->full_stalls = 0;
+    w->submitted   = 0;
+#endif
+    ili->win.cmds_skipped       = 0;
+    ili->coalesce.rects_in      = 0;
+    ili->coalesce.rects_out     = 0;
+    ili->coalesce.bytes_saved   = 0;
+    ili->shadow.tiles_checked   = 0;
+    ili->shadow.tiles_unchanged = 0;
+    ili->shadow.bytes_skipped   = 0;
+    // TE frames and timeouts stay: the scheduler goes by them
+    ili->te.waits           = 0;
+    ili->te.wait_us_max     = 0;
+    ili->te.wait_us_total   = 0;
+    ili->te.chase_fallbacks = 0;
+
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili9486_stats_t *s = &ili->stats;
+    s->flushes        = 0;
+    s->errors         = 0;
+    s->pixels         = 0;
+    s->bytes_sent     = 0;
+    s->commands_sent  = 0;
+    s->conv_pixels    = 0;
+    s->conv_cycles    = 0;
+    s->queue_us_total = 0;
+    s->queue_us_max   = 0;
+    portENTER_CRITICAL(&s->lock);
+    s->wire_us_total  = 0;
+    s->wire_us_max    = 0;
+    s->wire_flushes   = 0;
+    portEXIT_CRITICAL(&s->lock);
+#if CONFIG_ILI9486_STATS_HISTOGRAM
+    memset(s->flush_size_hist, 0, sizeof(s->flush_size_hist));
+#endif
+#endif
+    return ESP_OK;
+}
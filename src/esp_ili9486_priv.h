@@ -0,0 +1,363 @@
+// ─── esp_ili9486_priv.h ─────────────────────────────────────────────────────
+// Driver internals shared between the translation units in src/.
+#pragma once
+#include <stdatomic.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_lcd_panel_interface.h"
+#include "esp_ili9486_panel.h"
+#include "esp_ili9486_convert.h"
+
+#define LCD_H_RES 320
+#define LCD_V_RES 480
+#if CONFIG_ILI9486_PIPELINED_FLUSH
+// Two small ping-pong chunks: chunk k+1 is converted while chunk k is on
+// the wire.
+#define CONV_BUF_DEFAULT_PIXELS CONFIG_ILI9486_PIPELINE_CHUNK_PIXELS
+#define CONV_BUF_COUNT          2
+#else
+#define CONV_BUF_DEFAULT_PIXELS (LCD_H_RES * 80)
+#define CONV_BUF_COUNT          1
+#endif
+// PSRAM DMA needs cache-line aligned buffers; harmless for internal RAM
+#define CONV_BUF_ALIGN          64
+// Solid-fill pattern, queued over and over by fill_rect()
+#define FILL_BUF_PIXELS         (LCD_H_RES * 4)
+// Dirty-rectangle coalescing: rectangles held per frame (a group is a
+// bitmask of them), and cost model defaults in bus bytes
+#define COALESCE_DEFAULT_RECTS  16
+#define COALESCE_MAX_RECTS      32
+#define COALESCE_SETUP_BYTES    128
+#define COALESCE_SPAN_BYTES_ZC  32      // zero-copy: one more queued DMA
+#define COALESCE_SPAN_BYTES     4       // conversion: one more kernel call
+// Encoded parameters of init table entries queued back to back; holds
+// the default table's run after SLPOUT at 16-bit padding
+#define INIT_BATCH_BYTES        96
+// Shadow framebuffer tile edge; divides both 320 and 480
+#define SHADOW_TILE             16
+#define SHADOW_TILES            ((LCD_H_RES / SHADOW_TILE) * (LCD_V_RES / SHADOW_TILE))
+
+// One draw_bitmap() call, in the caller's coordinates (gap not applied)
+typedef struct {
+    int x_start;
+    int y_start;
+    int x_end;
+    int y_end;
+    const void *color_data;
+    int stride;                     // source row pitch in pixels, >= x_end - x_start
+#if CONFIG_ILI9486_ENABLE_STATS || CONFIG_ILI9486_CONVERTER_TASK
+    int64_t t_draw_us;              // when draw_bitmap() was called
+#endif
+} ili9486_region_t;
+
+// Last GRAM window programmed into the panel (panel coordinates, end
+// exclusive). Columns and rows are tracked separately so a row-by-row
+// producer only pays RASET.
+typedef struct {
+    bool col_valid;
+    bool row_valid;
+    int x_start;
+    int x_end;
+    int y_start;
+    int y_end;
+    uint8_t caset[8];               // queued parameter blocks, see set_window
+    uint8_t raset[8];
+    uint32_t cmds_skipped;
+} ili9486_window_t;
+
+// Hardware vertical scroll state (VSCRDEF / VSCRSADD), in GRAM lines.
+// Logical row top_fixed + k of the scroll area shows GRAM line
+// top_fixed + (k + offset) % scroll_lines.
+typedef struct {
+    bool active;
+    int top_fixed;
+    int scroll_lines;
+    int offset;
+    uint8_t vscrdef[12];            // queued parameter blocks
+    uint8_t vscrsadd[4];
+} ili9486_scroll_t;
+
+// A set of frame rectangles written as one window. The bounding box is
+// in the caller's coordinates and fully covered by the members.
+typedef struct {
+    uint32_t members;               // bit i: rects[i]
+    int x_start;
+    int y_start;
+    int x_end;
+    int y_end;
+    int32_t cost;                   // per the cost model, in bus bytes
+} ili9486_rect_group_t;
+
+// Part of one window row taken from a single rectangle
+typedef struct {
+    int rect;
+    int x_start;
+    int x_end;
+} ili9486_span_t;
+
+// Rectangles collected between begin_frame() and end_frame(). The arrays
+// are allocated on the first begin_frame().
+typedef struct {
+    bool open;
+    int max_rects;
+    int setup_bytes;
+    int span_bytes;
+    int wire_bytes_per_pixel;
+    int count;
+    ili9486_region_t *rects;
+    ili9486_rect_group_t *groups;
+    ili9486_span_t *spans;          // one row, at most 2 * max_rects + 1
+    bool queued;                    // some window of this frame was sent
+    uint32_t rects_in;
+    uint32_t rects_out;
+    uint64_t bytes_saved;
+} ili9486_coalesce_t;
+
+// Shadow of the panel GRAM (vendor flags.shadow_fb), in panel columns
+// and GRAM lines, holding the caller's pixel format. Tiles are row-major,
+// tiles_x per row.
+#define SHADOW_VALID            0x01    // hash matches what GRAM holds
+#define SHADOW_DIRTY            0x02    // changed by the flush in progress
+typedef struct {
+    bool enabled;
+    uint8_t *pixels;                // NULL: hashes only
+    // Per tile and tile row, the columns whose shadow pixels are known,
+    // for tiles not valid yet (kept with pixels)
+    uint16_t (*known)[SHADOW_TILE];
+    uint32_t *hash;                 // FNV-1a of each tile
+    uint8_t *state;                 // SHADOW_* flags of each tile
+    int cols;                       // 480 with MV, else 320
+    int rows;
+    int tiles_x;
+    uint32_t tiles_checked;
+    uint32_t tiles_unchanged;
+    uint64_t bytes_skipped;
+} ili9486_shadow_t;
+
+// TE scheduling state. The ISR owns last_us/frames/period_us and the
+// per-frame wait figures (under lock); the flushing task owns the rest.
+typedef struct {
+    int gpio_num;                   // -1 when TE scheduling is off
+    ili9486_te_mode_t mode;
+    SemaphoreHandle_t sem;          // given on every TE pulse
+    portMUX_TYPE lock;
+    uint32_t last_us;               // timestamp of the latest pulse
+    uint32_t frames;
+    uint32_t period_us;             // averaged frame period, 0 = unknown
+    uint32_t wait_us_frame;         // waited since the latest pulse
+    uint32_t wait_us_last_frame;    // waited during the previous frame
+    uint32_t waits;
+    uint32_t timeouts;
+    uint64_t wait_us_total;
+    uint32_t wait_us_max;
+    uint32_t chase_fallbacks;
+    // Bus rate, timed from the release of a flush to its wire-done event
+    // (under lock). write_bytes is 0 while no flush is being timed.
+    uint32_t ns_per_byte;           // averaged, 0 = not measured yet
+    int64_t write_start_us;
+    uint32_t write_bytes;
+    uint8_t teon_param;             // queued TEON parameter
+} ili9486_te_t;
+
+// Init sequence in progress (init_begin / init_poll). Steps 0 .. count-1
+// are the table, step count the commands built from the panel state.
+typedef struct {
+    const ili9486_lcd_init_cmd_t *cmds;
+    size_t count;
+    size_t next;
+    bool active;
+    bool after_hw_reset;            // SWRESET is covered by the reset pulse
+    int64_t due_us;                 // earliest time for step next
+    uint8_t batch[INIT_BATCH_BYTES];  // parameters of the queued entries
+    size_t batch_len;
+} ili9486_init_t;
+
+#if CONFIG_ILI9486_ENABLE_STATS
+// Flush instrumentation. The ISR owns the wire_* figures (under lock);
+// draw_bitmap() callers count flushes and the histogram, and the
+// flushing task owns the rest.
+typedef struct {
+    portMUX_TYPE lock;
+    uint32_t flushes;
+    uint32_t errors;
+    uint64_t pixels;
+    uint64_t bytes_sent;
+    uint32_t commands_sent;
+    uint64_t conv_pixels;
+    uint64_t conv_cycles;
+    uint64_t queue_us_total;
+    uint32_t queue_us_max;
+    uint64_t frame_pixels;          // drawn into the open frame so far
+    int64_t flush_start_us;         // of the flush being sent
+    bool first_tx_pending;          // its first pixel transfer is not queued yet
+    volatile int64_t wire_start_us;
+    uint64_t wire_us_total;
+    uint32_t wire_flushes;
+    uint32_t wire_us_max;
+#if CONFIG_ILI9486_STATS_HISTOGRAM
+    uint32_t flush_size_hist[ILI9486_FLUSH_HIST_BUCKETS];
+#endif
+} ili9486_stats_t;
+#endif
+
+#if CONFIG_ILI9486_CONVERTER_TASK
+// Single-producer (draw_bitmap caller) / single-consumer (converter task)
+// ring. head and tail run freely and are masked on access. The consumer
+// advances tail only after a region is fully queued to SPI, so
+// head == tail also means the task is idle.
+typedef struct {
+    TaskHandle_t task;
+    SemaphoreHandle_t space_sem;    // given by the task after each region
+    SemaphoreHandle_t exited;       // given by the task as its last action
+    ili9486_region_t *ring;
+    uint32_t size;                  // power of two
+    atomic_uint head;               // written by the producer only
+    atomic_uint tail;               // written by the converter task only
+    atomic_bool producer_waiting;
+    volatile bool exit;
+    // Bus group whose scheduler task consumes the ring instead of a task
+    // of the panel's own (task then points at the group's)
+    struct esp_lcd_ili9486_bus_group_t *group;
+    uint32_t submitted;
+    uint32_t high_water;
+    uint32_t full_stalls;
+} ili9486_worker_t;
+#endif
+
+typedef struct {
+    esp_lcd_panel_t base;
+    esp_lcd_panel_io_handle_t io;
+    int reset_gpio_num;
+    bool hw_reset_pending;              // pulsed since the last init
+    int64_t hw_reset_us;                // end of the last reset pulse
+    const ili9486_lcd_init_cmd_t *init_cmds;
+    size_t init_cmds_size;
+    const void *splash;                 // vendor splash, written by every init
+    size_t splash_size;
+    ili9486_init_t init;
+    int x_gap;
+    int y_gap;
+    uint8_t madctl;
+    int width;                          // logical, in the current MADCTL order
+    int height;
+    bool sw_orientation;                // set_orientation() rotates in draw_bitmap()
+    ili9486_xform_t sw_xform;           // screen to panel order, with sw_orientation
+    uint8_t colmod;
+    bool invert_color;
+    bool zero_copy;                     // color_data goes to the wire as is
+    uint8_t src_bytes_per_pixel;        // of color_data: 2 (RGB565) or 3 (RGB888)
+    bool swap_rb;                       // RGB888 input: B,G,R on the wire, BGR flipped
+    bool pad_params;                    // 16-bit padded command parameters
+    uint8_t *conv_buf[CONV_BUF_COUNT];  // RGB666, 3 bytes per pixel
+    size_t conv_buf_pixels;             // capacity of each conv_buf
+    int conv_idx;                       // next conv_buf to convert into
+    uint8_t *fill_buf;                  // allocated on the first fill_rect() or draw_indexed()
+    ili9486_conv_fn_t conv;             // RGB565 -> RGB666 kernel
+    ili9486_window_t win;
+    ili9486_scroll_t scroll;
+    ili9486_te_t te;
+    ili9486_coalesce_t coalesce;
+    ili9486_shadow_t shadow;
+    esp_lcd_panel_ili9486_callbacks_t cbs;
+    void *user_ctx;
+    // Completion tracking: every tx_color() the driver issues bumps tx_seq
+    // and produces exactly one on_color_trans_done, which bumps done_seq.
+    // When done_seq reaches flush_end_seq the flush is off the wire.
+    uint32_t tx_seq;
+    volatile uint32_t done_seq;
+    volatile uint32_t flush_end_seq;
+    bool done_events;                   // on_color_trans_done is ours
+#if CONFIG_ILI9486_CONVERTER_TASK
+    ili9486_worker_t worker;
+#endif
+#if CONFIG_ILI9486_ENABLE_STATS
+    ili9486_stats_t stats;
+#endif
+} ili9486_panel_t;
+
+// draw_bitmap() behind the esp_lcd entry point: hold the region for the
+// open frame, hand it to the converter task or flush it right away.
+esp_err_t ili9486_draw_region(ili9486_panel_t *ili, const ili9486_region_t *region);
+// Convert and send one region, then release its source buffer.
+esp_err_t ili9486_flush_region(ili9486_panel_t *ili, const ili9486_region_t *region);
+
+// Merge the frame's rectangles into groups, stored in emission order.
+// Returns the number of groups.
+int ili9486_coalesce_plan(ili9486_coalesce_t *c);
+// Spans of row y of a group's window, left to right, each taken from the
+// latest member covering it. Returns the span count, or -1 if part of the
+// row is not covered.
+int ili9486_coalesce_row(const ili9486_coalesce_t *c, uint32_t members,
+                         int x_start, int x_end, int y, ili9486_span_t *spans);
+
+// Shadow framebuffer (vendor flags.shadow_fb). The update/invalidate
+// calls are no-ops while it is disabled. Coordinates are panel columns
+// and GRAM lines, end exclusive.
+esp_err_t ili9486_shadow_init(ili9486_panel_t *ili, const ili9486_vendor_config_t *vcfg);
+void ili9486_shadow_free(ili9486_panel_t *ili);
+// Forget all tiles: GRAM was reset or its addressing (MADCTL) changed
+void ili9486_shadow_reset(ili9486_panel_t *ili);
+// GRAM was written without going through the shadow
+void ili9486_shadow_invalidate(ili9486_panel_t *ili, int x_start, int line_start,
+                               int x_end, int line_end);
+// Compare a piece of a draw, row_bytes apart in src, with the shadow and
+// take it over. Tiles whose content changed are marked dirty; returns
+// how many pieces were.
+int ili9486_shadow_update(ili9486_panel_t *ili, int x_start, int line_start,
+                          int x_end, int line_end, const uint8_t *src, size_t row_bytes);
+bool ili9486_shadow_dirty(const ili9486_panel_t *ili, int x, int line);
+void ili9486_shadow_clear_dirty(ili9486_panel_t *ili, int x_start, int line_start,
+                                int x_end, int line_end);
+
+// Boot splash decoder (vendor splash), reading the image in place
+typedef struct {
+    int width;
+    int height;
+    uint16_t background;
+    const uint8_t *palette;         // NULL: pixels are RGB565 values
+    size_t colors;
+    const uint8_t *next;            // next packet byte
+    const uint8_t *end;
+    size_t left;                    // pixels left in the current packet
+    bool run;
+    uint16_t color;                 // of the current run
+} ili9486_splash_t;
+
+// Check the header and start decoding at the first pixel
+esp_err_t ili9486_splash_open(ili9486_splash_t *s, const void *data, size_t size);
+// Decode the next n pixels (row-major) as RGB565 into dst, or drop them
+// if dst is NULL. Fails on a truncated or malformed image.
+esp_err_t ili9486_splash_read(ili9486_splash_t *s, uint16_t *dst, size_t n);
+
+// TE scheduling (vendor flags.te_enable), a no-op when disabled
+esp_err_t ili9486_te_start(ili9486_panel_t *ili, const ili9486_vendor_config_t *vcfg);
+void ili9486_te_stop(ili9486_panel_t *ili);
+// Hold the caller until writing the window (panel coordinates, end
+// exclusive) cannot tear, per the configured mode.
+void ili9486_te_wait(ili9486_panel_t *ili, int x_start, int y_start, int x_end, int y_end);
+// The flush last released by ili9486_te_wait() is off the wire (ISR)
+void ili9486_te_write_done(ili9486_panel_t *ili);
+
+#if CONFIG_ILI9486_CONVERTER_TASK
+esp_err_t ili9486_worker_start(ili9486_panel_t *ili);
+void ili9486_worker_stop(ili9486_panel_t *ili);
+// Hand a region to the converter task; blocks only while the ring is full.
+void ili9486_worker_submit(ili9486_panel_t *ili, const ili9486_region_t *region);
+// Consumer side, for whichever task owns the ring: flush the oldest
+// region and retire it. Returns false if the ring was empty.
+bool ili9486_worker_run_one(ili9486_panel_t *ili);
+// The region run_one() would flush next, or NULL
+const ili9486_region_t *ili9486_worker_peek(ili9486_panel_t *ili);
+// Hand the ring over to a bus group's task, ending the panel's own, or
+// back (group NULL, task started again)
+esp_err_t ili9486_worker_set_group(ili9486_panel_t *ili, struct esp_lcd_ili9486_bus_group_t *group,
+                                   TaskHandle_t task);
+// Called by worker_stop() for a panel still in a group
+void ili9486_bus_group_leave(struct esp_lcd_ili9486_bus_group_t *group, ili9486_panel_t *ili);
+// Wait until every submitted region has been queued to SPI.
+void ili9486_worker_sync(ili9486_panel_t *ili);
+#else
+static inline void ili9486_worker_sync(ili9486_panel_t *ili) { (void)ili; }
+#endif
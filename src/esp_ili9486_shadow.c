@@ -0,0 +1,215 @@
+// ─── esp_ili9486_shadow.c ───────────────────────────────────────────────────
+// Shadow framebuffer for draw_bitmap() change detection. GRAM is split
+// into SHADOW_TILE x SHADOW_TILE tiles, each with an FNV-1a hash of its
+// pixels in the caller's format. A draw covering a whole tile is checked
+// by hash alone, without touching the shadow pixels; a partly covered
+// tile is compared against the pixels, kept in PSRAM. Without PSRAM only
+// the hashes are kept and partly covered tiles are always sent.
+#include <string.h>
+#include <sys/param.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_ili9486_priv.h"
+
+static const char *TAG = "ili9486_shadow";
+
+#define FNV_OFFSET 0x811C9DC5u
+#define FNV_PRIME  0x01000193u
+
+// FNV-1a over 32-bit words: a tile row is 32 or 48 bytes
+static uint32_t ili9486_fnv_rows(uint32_t h, const uint8_t *src, size_t row_bytes,
+                                 size_t stride, int rows)
+{
+    for (int r = 0; r < rows; r++, src += stride) {
+        for (size_t i = 0; i < row_bytes; i += 4) {
+            uint32_t w;
+            memcpy(&w, src + i, 4);
+            h = (h ^ w) * FNV_PRIME;
+        }
+    }
+    return h;
+}
+
+esp_err_t ili9486_shadow_init(ili9486_panel_t *ili, const ili9486_vendor_config_t *vcfg)
+{
+    ili9486_shadow_t *s = &ili->shadow;
+    if (!vcfg || !vcfg->flags.shadow_fb) {
+        return ESP_OK;
+    }
+
+    s->hash  = heap_caps_calloc(SHADOW_TILES, sizeof(s->hash[0]), MALLOC_CAP_DEFAULT);
+    s->state = heap_caps_calloc(SHADOW_TILES, sizeof(s->state[0]), MALLOC_CAP_DEFAULT);
+    ESP_RETURN_ON_FALSE(s->hash && s->state, ESP_ERR_NO_MEM, TAG, "no memory for tile hashes");
+    // Only the CPU reads the shadow pixels, so they need not be DMA-capable
+    s->pixels = heap_caps_malloc(LCD_H_RES * LCD_V_RES * ili->src_bytes_per_pixel,
+                                 MALLOC_CAP_SPIRAM);
+    s->known  = heap_caps_malloc(SHADOW_TILES * sizeof(s->known[0]), MALLOC_CAP_SPIRAM);
+    if (!s->pixels || !s->known) {
+        ESP_LOGI(TAG, "no PSRAM for shadow pixels, partly covered tiles are always sent");
+        heap_caps_free(s->pixels);
+        heap_caps_free(s->known);
+        s->pixels = NULL;
+        s->known  = NULL;
+    }
+    s->enabled = true;
+    ili9486_shadow_reset(ili);
+    return ESP_OK;
+}
+
+void ili9486_shadow_free(ili9486_panel_t *ili)
+{
+    ili9486_shadow_t *s = &ili->shadow;
+    heap_caps_free(s->pixels);
+    heap_caps_free(s->known);
+    heap_caps_free(s->hash);
+    heap_caps_free(s->state);
+    s->pixels  = NULL;
+    s->known   = NULL;
+    s->hash    = NULL;
+    s->state   = NULL;
+    s->enabled = false;
+}
+
+void ili9486_shadow_reset(ili9486_panel_t *ili)
+{
+    ili9486_shadow_t *s = &ili->shadow;
+    if (!s->enabled) {
+        return;
+    }
+    s->cols    = ili->width;
+    s->rows    = ili->height;
+    s->tiles_x = s->cols / SHADOW_TILE;
+    memset(s->state, 0, SHADOW_TILES);
+    if (s->known) {
+        memset(s->known, 0, SHADOW_TILES * sizeof(s->known[0]));
+    }
+}
+
+void ili9486_shadow_invalidate(ili9486_panel_t *ili, int x_start, int line_start,
+                               int x_end, int line_end)
+{
+    ili9486_shadow_t *s = &ili->shadow;
+    if (!s->enabled) {
+        return;
+    }
+    x_start = MAX(x_start, 0);
+    line_start = MAX(line_start, 0);
+    x_end = MIN(x_end, s->cols);
+    line_end = MIN(line_end, s->rows);
+    for (int ty = line_start / SHADOW_TILE; ty * SHADOW_TILE < line_end; ty++) {
+        for (int tx = x_start / SHADOW_TILE; tx * SHADOW_TILE < x_end; tx++) {
+            s->state[ty * s->tiles_x + tx] &= ~SHADOW_VALID;
+            if (s->known) {
+                memset(s->known[ty * s->tiles_x + tx], 0, sizeof(s->known[0]));
+            }
+        }
+    }
+}
+
+// One tile's share of a draw: src points at its first pixel.
+static bool ili9486_shadow_piece(ili9486_panel_t *ili, int tx, int ty,
+                                 int x_start, int line_start, int x_end, int line_end,
+                                 const uint8_t *src, size_t row_bytes)
+{
+    ili9486_shadow_t *s = &ili->shadow;
+    const size_t bpp   = ili->src_bytes_per_pixel;
+    const size_t pitch = s->cols * bpp;
+    const int tile     = ty * s->tiles_x + tx;
+    const int width    = x_end - x_start;
+    const int rows     = line_end - line_start;
+    uint8_t *shadow    = s->pixels ? s->pixels + line_start * pitch + x_start * bpp : NULL;
+    const int r0       = line_start % SHADOW_TILE;
+    const uint16_t cols = (uint16_t)(((1u << width) - 1) << (x_start % SHADOW_TILE));
+
+    if (width == SHADOW_TILE && rows == SHADOW_TILE) {
+        uint32_t h = ili9486_fnv_rows(FNV_OFFSET, src, width * bpp, row_bytes, rows);
+        if ((s->state[tile] & SHADOW_VALID) && s->hash[tile] == h) {
+            return false;
+        }
+        s->hash[tile]   = h;
+        s->state[tile] |= SHADOW_VALID;
+    } else {
+        // A partial tile can only be matched against known pixels
+        bool same = shadow != NULL;
+        for (int r = 0; r < rows && same && !(s->state[tile] & SHADOW_VALID); r++) {
+            same = (s->known[tile][r0 + r] & cols) == cols;
+        }
+        for (int r = 0; r < rows && same; r++) {
+            same = memcmp(shadow + r * pitch, src + r * row_bytes, width * bpp) == 0;
+        }
+        if (same) {
+            return false;
+        }
+        if (!shadow) {
+            s->state[tile] &= ~SHADOW_VALID;
+        }
+    }
+
+    if (shadow) {
+        bool full = !(s->state[tile] & SHADOW_VALID);
+        for (int r = 0; r < rows; r++) {
+            memcpy(shadow + r * pitch, src + r * row_bytes, width * bpp);
+            s->known[tile][r0 + r] |= cols;
+        }
+        // Tile not valid yet: it becomes so once every pixel is known
+        for (int r = 0; r < SHADOW_TILE && full; r++) {
+            full = s->known[tile][r] == 0xFFFF;
+        }
+        if (full) {
+            s->state[tile] |= SHADOW_VALID;
+        }
+        // Rest of a valid tile is known: rehash it from the shadow
+        if (s->state[tile] & SHADOW_VALID && (width != SHADOW_TILE || rows != SHADOW_TILE)) {
+            const uint8_t *t = s->pixels + ty * SHADOW_TILE * pitch + tx * SHADOW_TILE * bpp;
+            s->hash[tile] = ili9486_fnv_rows(FNV_OFFSET, t, SHADOW_TILE * bpp, pitch,
+                                             SHADOW_TILE);
+        }
+    }
+    return true;
+}
+
+int ili9486_shadow_update(ili9486_panel_t *ili, int x_start, int line_start,
+                          int x_end, int line_end, const uint8_t *src, size_t row_bytes)
+{
+    ili9486_shadow_t *s = &ili->shadow;
+    const size_t bpp  = ili->src_bytes_per_pixel;
+    const size_t wire = ili->zero_copy ? bpp : 3;
+    int changed = 0;
+
+    for (int ty = line_start / SHADOW_TILE; ty * SHADOW_TILE < line_end; ty++) {
+        int l0 = MAX(line_start, ty * SHADOW_TILE);
+        int l1 = MIN(line_end, (ty + 1) * SHADOW_TILE);
+        for (int tx = x_start / SHADOW_TILE; tx * SHADOW_TILE < x_end; tx++) {
+            int x0 = MAX(x_start, tx * SHADOW_TILE);
+            int x1 = MIN(x_end, (tx + 1) * SHADOW_TILE);
+            const uint8_t *p = src + (l0 - line_start) * row_bytes + (x0 - x_start) * bpp;
+            s->tiles_checked++;
+            if (ili9486_shadow_piece(ili, tx, ty, x0, l0, x1, l1, p, row_bytes)) {
+                s->state[ty * s->tiles_x + tx] |= SHADOW_DIRTY;
+                changed++;
+            } else {
+                s->tiles_unchanged++;
+                s->bytes_skipped += (uint64_t)(x1 - x0) * (l1 - l0) * wire;
+            }
+        }
+    }
+    return changed;
+}
+
+bool ili9486_shadow_dirty(const ili9486_panel_t *ili, int x, int line)
+{
+    const ili9486_shadow_t *s = &ili->shadow;
+    return s->state[(line / SHADOW_TILE) * s->tiles_x + x / SHADOW_TILE] & SHADOW_DIRTY;
+}
+
+void ili9486_shadow_clear_dirty(ili9486_panel_t *ili, int x_start, int line_start,
+                                int x_end, int line_end)
+{
+    ili9486_shadow_t *s = &ili->shadow;
+    for (int ty = line_start / SHADOW_TILE; ty * SHADOW_TILE < line_end; ty++) {
+        for (int tx = x_start / SHADOW_TILE; tx * SHADOW_TILE < x_end; tx++) {
+            s->state[ty * s->tiles_x + tx] &= ~SHADOW_DIRTY;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+// ─── esp_ili9486_splash.c ───────────────────────────────────────────────────
+// Boot splash decoder (vendor splash). The image is read in place, from
+// flash, and decoded a few pixels at a time; see esp_ili9486_panel.h for
+// the format.
+#include <string.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_ili9486_priv.h"
+
+static const char *TAG = "ili9486_splash";
+
+#define SPLASH_MAGIC        "ISPL"
+#define SPLASH_VERSION      1
+#define SPLASH_FLAG_PALETTE 0x01
+#define SPLASH_HEADER_SIZE  14
+#define SPLASH_RUN          0x80
+
+static uint16_t splash_u16(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+esp_err_t ili9486_splash_open(ili9486_splash_t *s, const void *data, size_t size)
+{
+    const uint8_t *p = data;
+    ESP_RETURN_ON_FALSE(p && size >= SPLASH_HEADER_SIZE && !memcmp(p, SPLASH_MAGIC, 4),
+                        ESP_ERR_INVALID_ARG, TAG, "not a splash image");
+    ESP_RETURN_ON_FALSE(p[4] == SPLASH_VERSION, ESP_ERR_NOT_SUPPORTED, TAG,
+                        "splash version %d not supported", p[4]);
+
+    size_t colors = splash_u16(p + 12);
+    bool palette = p[5] & SPLASH_FLAG_PALETTE;
+    ESP_RETURN_ON_FALSE(palette ? colors > 0 && colors <= 256 : colors == 0,
+                        ESP_ERR_INVALID_ARG, TAG, "bad splash palette size %u", (unsigned)colors);
+    ESP_RETURN_ON_FALSE(size >= SPLASH_HEADER_SIZE + 2 * colors, ESP_ERR_INVALID_SIZE, TAG,
+                        "splash image truncated");
+
+    *s = (ili9486_splash_t) {
+        .width      = splash_u16(p + 6),
+        .height     = splash_u16(p + 8),
+        .background = splash_u16(p + 10),
+        .palette    = palette ? p + SPLASH_HEADER_SIZE : NULL,
+        .colors     = colors,
+        .next       = p + SPLASH_HEADER_SIZE + 2 * colors,
+        .end        = p + size,
+    };
+    ESP_RETURN_ON_FALSE(s->width > 0 && s->height > 0, ESP_ERR_INVALID_ARG, TAG,
+                        "empty splash image");
+    return ESP_OK;
+}
+
+// The colour at p, an index or an RGB565 value
+static esp_err_t splash_value(ili9486_splash_t *s, const uint8_t *p, uint16_t *color)
+{
+    if (!s->palette) {
+        *color = splash_u16(p);
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_FALSE(*p < s->colors, ESP_ERR_INVALID_ARG, TAG, "splash index out of range");
+    *color = splash_u16(s->palette + 2 * *p);
+    return ESP_OK;
+}
+
+esp_err_t ili9486_splash_read(ili9486_splash_t *s, uint16_t *dst, size_t n)
+{
+    const size_t value_bytes = s->palette ? 1 : 2;
+    while (n > 0) {
+        if (s->left == 0) {
+            // Next packet: a run needs one value, a literal left of them
+            ESP_RETURN_ON_FALSE(s->next < s->end, ESP_ERR_INVALID_SIZE, TAG,
+                                "splash image truncated");
+            uint8_t h = *s->next++;
+            s->run  = h & SPLASH_RUN;
+            s->left = (h & ~SPLASH_RUN) + 1;
+            size_t bytes = (s->run ? 1 : s->left) * value_bytes;
+            ESP_RETURN_ON_FALSE((size_t)(s->end - s->next) >= bytes, ESP_ERR_INVALID_SIZE, TAG,
+                                "splash image truncated");
+            if (s->run) {
+                ESP_RETURN_ON_ERROR(splash_value(s, s->next, &s->color), TAG, "bad run");
+                s->next += value_bytes;
+            }
+        }
+
+        size_t k = n < s->left ? n : s->left;
+        if (s->run) {
+            for (size_t i = 0; dst && i < k; i++) {
+                dst[i] = s->color;
+            }
+        } else {
+            for (size_t i = 0; i < k; i++) {
+                uint16_t c;
+                ESP_RETURN_ON_ERROR(splash_value(s, s->next, &c), TAG, "bad literal");
+                s->next += value_bytes;
+                if (dst) {
+                    dst[i] = c;
+                }
+            }
+        }
+        if (dst) {
+            dst += k;
+        }
+        s->left -= k;
+        n       -= k;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,279 @@
+// ─── esp_ili9486_te.c ───────────────────────────────────────────────────────
+// Tearing-effect (TE) flush scheduling. With TEON the panel pulses its TE
+// pin at the start of every vertical blanking interval. The edge ISR
+// timestamps each pulse and measures the frame period, from which the
+// line being scanned out can be estimated; flushes are then held until
+// writing their rows cannot overlap the scan. Beam chasing also needs the
+// time the write takes, from the bus rate measured on earlier flushes.
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "driver/gpio.h"
+#include "esp_ili9486_priv.h"
+
+static const char *TAG = "ili9486_te";
+
+#define MADCTL_MY 0x80
+#define MADCTL_MV 0x20
+
+#define COLMOD_RGB565 0x55
+
+// Waiting for an edge gives up after this long if the period is still
+// unknown (no pulses yet, e.g. TE not wired).
+#define TE_DEFAULT_TIMEOUT_US 50000
+// VBLANK mode: a flush may start this fraction of a frame after the pulse
+#define TE_VBLANK_WINDOW_DIV  8
+
+static void ili9486_te_isr(void *arg)
+{
+    ili9486_te_t *te = arg;
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    BaseType_t woken = pdFALSE;
+
+    portENTER_CRITICAL_ISR(&te->lock);
+    if (te->frames > 0) {
+        uint32_t delta = now - te->last_us;
+        // An edge missed while the ISR was masked shows up as a double
+        // period; keep it out of the average.
+        if (te->period_us == 0) {
+            te->period_us = delta;
+        } else if (delta < 2 * te->period_us) {
+            te->period_us = (te->period_us * 7 + delta) / 8;
+        }
+    }
+    te->last_us = now;
+    te->frames++;
+    te->wait_us_last_frame = te->wait_us_frame;
+    te->wait_us_frame = 0;
+    portEXIT_CRITICAL_ISR(&te->lock);
+
+    xSemaphoreGiveFromISR(te->sem, &woken);
+    if (woken) {
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+esp_err_t ili9486_te_start(ili9486_panel_t *ili, const ili9486_vendor_config_t *vcfg)
+{
+    ili9486_te_t *te = &ili->te;
+    te->gpio_num = -1;
+    if (!vcfg || !vcfg->flags.te_enable) {
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_FALSE(vcfg->te_mode == ILI9486_TE_MODE_VBLANK ||
+                        vcfg->te_mode == ILI9486_TE_MODE_BEAM_CHASE,
+                        ESP_ERR_INVALID_ARG, TAG, "unsupported TE mode %d", vcfg->te_mode);
+
+    te->sem = xSemaphoreCreateBinary();
+    ESP_RETURN_ON_FALSE(te->sem, ESP_ERR_NO_MEM, TAG, "no memory for TE semaphore");
+    portMUX_INITIALIZE(&te->lock);
+    te->mode = vcfg->te_mode;
+
+    esp_err_t ret;
+    gpio_config_t te_conf = {
+        .mode         = GPIO_MODE_INPUT,
+        .pin_bit_mask = 1ULL << vcfg->te_gpio_num,
+        .intr_type    = GPIO_INTR_POSEDGE,
+    };
+    ESP_GOTO_ON_ERROR(gpio_config(&te_conf), err, TAG, "TE GPIO config failed");
+    // The service may already be installed by the application
+    ret = gpio_install_isr_service(0);
+    ESP_GOTO_ON_FALSE(ret == ESP_OK || ret == ESP_ERR_INVALID_STATE, ret, err, TAG,
+                      "GPIO ISR service install failed");
+    ESP_GOTO_ON_ERROR(gpio_isr_handler_add(vcfg->te_gpio_num, ili9486_te_isr, te), err,
+                      TAG, "TE ISR add failed");
+    te->gpio_num = vcfg->te_gpio_num;
+    return ESP_OK;
+
+err:
+    vSemaphoreDelete(te->sem);
+    te->sem = NULL;
+    return ret;
+}
+
+void ili9486_te_stop(ili9486_panel_t *ili)
+{
+    ili9486_te_t *te = &ili->te;
+    if (te->gpio_num < 0) {
+        return;
+    }
+    gpio_isr_handler_remove(te->gpio_num);
+    gpio_reset_pin(te->gpio_num);
+    vSemaphoreDelete(te->sem);
+    te->sem = NULL;
+    te->gpio_num = -1;
+}
+
+// Panel scan lines covered by a window, in scan order. Lines follow the
+// 480-row axis: page addresses normally, column addresses with MV, and
+// counted from the other end with MY.
+static void ili9486_te_lines(const ili9486_panel_t *ili, int x_start, int y_start,
+                             int x_end, int y_end, int *first, int *end)
+{
+    int lo = (ili->madctl & MADCTL_MV) ? x_start : y_start;
+    int hi = (ili->madctl & MADCTL_MV) ? x_end : y_end;
+    if (ili->madctl & MADCTL_MY) {
+        int t = LCD_V_RES - hi;
+        hi = LCD_V_RES - lo;
+        lo = t;
+    }
+    *first = lo;
+    *end = hi;
+}
+
+// Start timing the bus with this window, or add it to the flush being
+// timed. Only a flush with no wire-done event armed ahead of it can be
+// timed: the next event is then its own. The time includes converting
+// the first chunk, so the rate errs on the slow side.
+static void ili9486_te_time_write(ili9486_panel_t *ili, uint32_t bytes)
+{
+    ili9486_te_t *te = &ili->te;
+    if (!ili->done_events || (int32_t)(ili->flush_end_seq - ili->done_seq) > 0) {
+        return;
+    }
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&te->lock);
+    if (te->write_bytes == 0) {
+        te->write_start_us = now;
+    }
+    te->write_bytes += bytes;
+    portEXIT_CRITICAL(&te->lock);
+}
+
+void ili9486_te_write_done(ili9486_panel_t *ili)
+{
+    ili9486_te_t *te = &ili->te;
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_ISR(&te->lock);
+    if (te->write_bytes) {
+        uint32_t ns = (uint32_t)((uint64_t)(now - te->write_start_us) * 1000 / te->write_bytes);
+        te->ns_per_byte = te->ns_per_byte ? (te->ns_per_byte * 7 + ns) / 8 : ns;
+        te->write_bytes = 0;
+    }
+    portEXIT_CRITICAL_ISR(&te->lock);
+}
+
+// Beam chase: can a write of write_us, started with the scan on line
+// scan (outside the window), finish without the scan crossing rows still
+// being written? Below the window the write trails the scan and must be
+// done before the scan comes round to it again. Above it, a write that
+// runs along the scan only has to stay ahead of it, so it must be done
+// before the scan reaches the last row; with MV (each written row spans
+// every scan line of the window) or MY (written bottom up) it must be
+// done before the scan reaches the first.
+static bool ili9486_te_chase_fits(const ili9486_panel_t *ili, uint32_t period,
+                                  int scan, int first, int end, uint64_t write_us)
+{
+    int lines;
+    if (scan >= end) {
+        lines = LCD_V_RES - scan + first;
+    } else if (ili->madctl & (MADCTL_MV | MADCTL_MY)) {
+        lines = first - scan;
+    } else {
+        lines = end - scan;
+    }
+    return write_us * LCD_V_RES <= (uint64_t)lines * period;
+}
+
+// Block until the next TE pulse. Returns false on timeout.
+static bool ili9486_te_wait_edge(ili9486_te_t *te)
+{
+    uint32_t timeout_us = te->period_us ? 2 * te->period_us : TE_DEFAULT_TIMEOUT_US;
+    xSemaphoreTake(te->sem, 0);     // only a pulse from now on counts
+    return xSemaphoreTake(te->sem, pdMS_TO_TICKS(timeout_us / 1000) + 1) == pdTRUE;
+}
+
+static void ili9486_te_delay_us(uint32_t us)
+{
+    uint32_t tick_us = portTICK_PERIOD_MS * 1000;
+    if (us >= tick_us) {
+        vTaskDelay(us / tick_us);
+        us %= tick_us;
+    }
+    esp_rom_delay_us(us);
+}
+
+void ili9486_te_wait(ili9486_panel_t *ili, int x_start, int y_start, int x_end, int y_end)
+{
+    ili9486_te_t *te = &ili->te;
+    int64_t t0 = esp_timer_get_time();
+    bool waited = false;
+    bool vblank = te->mode == ILI9486_TE_MODE_VBLANK;
+    uint32_t bytes = (uint32_t)(x_end - x_start) * (uint32_t)(y_end - y_start) *
+                     (ili->colmod == COLMOD_RGB565 ? 2 : 3);
+
+    // Never seen a pulse and already timed out once: TE is not wired or
+    // not enabled on the panel. Do not stall every flush on it.
+    if (te->frames == 0 && te->timeouts > 0) {
+        return;
+    }
+
+    for (;;) {
+        uint32_t now = (uint32_t)esp_timer_get_time();
+        portENTER_CRITICAL(&te->lock);
+        uint32_t period  = te->period_us;
+        uint32_t elapsed = now - te->last_us;
+        uint32_t frames  = te->frames;
+        uint32_t ns_per_byte = te->ns_per_byte;
+        portEXIT_CRITICAL(&te->lock);
+
+        // Without a measured period (or after a missed pulse) the scan
+        // position is unknown: resynchronise on the next pulse.
+        if (frames < 2 || period == 0 || elapsed >= period) {
+            waited = true;
+            if (!ili9486_te_wait_edge(te)) {
+                if (te->timeouts++ == 0 && te->frames == 0) {
+                    ESP_LOGW(TAG, "no TE pulse on GPIO %d, flushing unsynchronised",
+                             te->gpio_num);
+                }
+                break;
+            }
+            continue;
+        }
+
+        if (vblank) {
+            if (elapsed < period / TE_VBLANK_WINDOW_DIV) {
+                break;
+            }
+            waited = true;
+            if (!ili9486_te_wait_edge(te)) {
+                te->timeouts++;
+                break;
+            }
+            continue;
+        }
+
+        // Beam chase: hold while the line being scanned lies inside the
+        // window. Outside it, go if the write is quick enough to race
+        // ahead of the scan or to trail it; if it is not, or the bus rate
+        // is not known yet, wait for VBLANK instead.
+        int first, end;
+        ili9486_te_lines(ili, x_start, y_start, x_end, y_end, &first, &end);
+        int scan = (int)((uint64_t)elapsed * LCD_V_RES / period);
+        if (scan >= first && scan < end) {
+            waited = true;
+            ili9486_te_delay_us((uint32_t)((uint64_t)(end - scan) * period / LCD_V_RES) + 1);
+            continue;
+        }
+        if (ns_per_byte && ili9486_te_chase_fits(ili, period, scan, first, end,
+                                                 (uint64_t)bytes * ns_per_byte / 1000)) {
+            break;
+        }
+        te->chase_fallbacks++;
+        vblank = true;
+    }
+    ili9486_te_time_write(ili, bytes);
+
+    if (waited) {
+        uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+        portENTER_CRITICAL(&te->lock);
+        te->wait_us_frame += us;
+        portEXIT_CRITICAL(&te->lock);
+        te->waits++;
+        te->wait_us_total += us;
+        if (us > te->wait_us_max) {
+            te->wait_us_max = us;
+        }
+    }
+}
@@ -0,0 +1,212 @@
+// ─── esp_ili9486_worker.c ───────────────────────────────────────────────────
+// Optional converter task: draw_bitmap() only records the region in a
+// lock-free SPSC ring and returns; the task, pinned to its own core,
+// converts RGB565 → RGB666 and feeds the SPI queue, so rendering and
+// conversion run in parallel.
+#include "sdkconfig.h"
+#if CONFIG_ILI9486_CONVERTER_TASK
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "esp_ili9486_priv.h"
+
+static const char *TAG = "ili9486_worker";
+
+#if CONFIG_ILI9486_CONVERTER_TASK_CORE < 0
+#define WORKER_CORE tskNO_AFFINITY
+#else
+#define WORKER_CORE CONFIG_ILI9486_CONVERTER_TASK_CORE
+#endif
+
+const ili9486_region_t *ili9486_worker_peek(ili9486_panel_t *ili)
+{
+    ili9486_worker_t *w = &ili->worker;
+    uint32_t tail = atomic_load_explicit(&w->tail, memory_order_relaxed);
+    if (tail == atomic_load_explicit(&w->head, memory_order_acquire)) {
+        return NULL;
+    }
+    return &w->ring[tail & (w->size - 1)];
+}
+
+bool ili9486_worker_run_one(ili9486_panel_t *ili)
+{
+    ili9486_worker_t *w = &ili->worker;
+    const ili9486_region_t *region = ili9486_worker_peek(ili);
+    if (!region) {
+        return false;
+    }
+
+    esp_err_t ret = ili9486_flush_region(ili, region);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "flush failed: %s", esp_err_to_name(ret));
+    }
+
+    // Publishing the new tail frees the slot and, if the ring is now
+    // empty, tells ili9486_worker_sync() that the task is idle.
+    uint32_t tail = atomic_load_explicit(&w->tail, memory_order_relaxed);
+    atomic_store_explicit(&w->tail, tail + 1, memory_order_release);
+    if (atomic_load(&w->producer_waiting)) {
+        xSemaphoreGive(w->space_sem);
+    }
+    return true;
+}
+
+static void ili9486_worker_task(void *arg)
+{
+    ili9486_panel_t *ili = arg;
+    ili9486_worker_t *w = &ili->worker;
+
+    while (!w->exit) {
+        if (!ili9486_worker_run_one(ili)) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+    }
+
+    xSemaphoreGive(w->exited);
+    vTaskDelete(NULL);
+}
+
+static esp_err_t ili9486_worker_spawn(ili9486_panel_t *ili)
+{
+    ili9486_worker_t *w = &ili->worker;
+    w->exit = false;
+    BaseType_t ok = xTaskCreatePinnedToCore(ili9486_worker_task, "ili9486_conv",
+                                            CONFIG_ILI9486_CONVERTER_TASK_STACK_SIZE,
+                                            ili, CONFIG_ILI9486_CONVERTER_TASK_PRIORITY,
+                                            &w->task, WORKER_CORE);
+    return ok == pdPASS ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+// End the panel's own task; the ring must be empty. Once `exited` is
+// taken the task touches nothing of ours any more, so the caller may
+// delete the semaphores.
+static void ili9486_worker_end_task(ili9486_worker_t *w)
+{
+    w->exit = true;
+    xTaskNotifyGive(w->task);
+    xSemaphoreTake(w->exited, portMAX_DELAY);
+    w->task = NULL;
+}
+
+// Block the producer until the task has retired at least one region.
+// producer_waiting is raised before the caller re-checks its condition, so
+// a region retired in between still leaves the semaphore given. The
+// timeout only bounds a missed wake-up, it is not needed for correctness.
+static void ili9486_worker_wait(ili9486_worker_t *w)
+{
+    xSemaphoreTake(w->space_sem, pdMS_TO_TICKS(10));
+}
+
+esp_err_t ili9486_worker_start(ili9486_panel_t *ili)
+{
+    ili9486_worker_t *w = &ili->worker;
+
+    uint32_t size = 1;
+    while (size < CONFIG_ILI9486_CONVERTER_QUEUE_DEPTH) {
+        size <<= 1;
+    }
+    w->size = size;
+    atomic_init(&w->head, 0);
+    atomic_init(&w->tail, 0);
+    atomic_init(&w->producer_waiting, false);
+
+    w->ring = heap_caps_calloc(size, sizeof(ili9486_region_t), MALLOC_CAP_INTERNAL);
+    ESP_RETURN_ON_FALSE(w->ring, ESP_ERR_NO_MEM, TAG, "no memory for ring");
+
+    w->space_sem = xSemaphoreCreateBinary();
+    w->exited = xSemaphoreCreateBinary();
+    if (!w->space_sem || !w->exited || ili9486_worker_spawn(ili) != ESP_OK) {
+        if (w->space_sem) {
+            vSemaphoreDelete(w->space_sem);
+        }
+        if (w->exited) {
+            vSemaphoreDelete(w->exited);
+        }
+        free(w->ring);
+        w->ring = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void ili9486_worker_stop(ili9486_panel_t *ili)
+{
+    ili9486_worker_t *w = &ili->worker;
+    if (!w->task) {
+        return;
+    }
+    ili9486_worker_sync(ili);
+
+    if (w->group) {
+        ili9486_bus_group_leave(w->group, ili);
+        w->group = NULL;
+        w->task  = NULL;
+    } else {
+        ili9486_worker_end_task(w);
+    }
+    vSemaphoreDelete(w->space_sem);
+    vSemaphoreDelete(w->exited);
+    free(w->ring);
+    w->ring = NULL;
+}
+
+esp_err_t ili9486_worker_set_group(ili9486_panel_t *ili, struct esp_lcd_ili9486_bus_group_t *group,
+                                   TaskHandle_t task)
+{
+    ili9486_worker_t *w = &ili->worker;
+    ili9486_worker_sync(ili);
+    if (group) {
+        if (!w->group) {
+            ili9486_worker_end_task(w);
+        }
+        w->group = group;
+        w->task  = task;
+        return ESP_OK;
+    }
+    w->group = NULL;
+    w->task  = NULL;
+    return ili9486_worker_spawn(ili);
+}
+
+void ili9486_worker_submit(ili9486_panel_t *ili, const ili9486_region_t *region)
+{
+    ili9486_worker_t *w = &ili->worker;
+    uint32_t head = atomic_load_explicit(&w->head, memory_order_relaxed);
+
+    if (head - atomic_load_explicit(&w->tail, memory_order_acquire) == w->size) {
+        w->full_stalls++;
+        atomic_store(&w->producer_waiting, true);
+        while (head - atomic_load_explicit(&w->tail, memory_order_acquire) == w->size) {
+            ili9486_worker_wait(w);
+        }
+        atomic_store(&w->producer_waiting, false);
+    }
+
+    w->ring[head & (w->size - 1)] = *region;
+    atomic_store_explicit(&w->head, head + 1, memory_order_release);
+    xTaskNotifyGive(w->task);
+
+    uint32_t used = head + 1 - atomic_load_explicit(&w->tail, memory_order_relaxed);
+    if (used > w->high_water) {
+        w->high_water = used;
+    }
+    w->submitted++;
+}
+
+void ili9486_worker_sync(ili9486_panel_t *ili)
+{
+    ili9486_worker_t *w = &ili->worker;
+    uint32_t head = atomic_load_explicit(&w->head, memory_order_relaxed);
+
+    if (head == atomic_load_explicit(&w->tail, memory_order_acquire)) {
+        return;
+    }
+    atomic_store(&w->producer_waiting, true);
+    while (head != atomic_load_explicit(&w->tail, memory_order_acquire)) {
+        ili9486_worker_wait(w);
+    }
+    atomic_store(&w->producer_waiting, false);
+}
+
+#endif // CONFIG_ILI9486_CONVERTER_TASK
@@ -0,0 +1,210 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_ili9486_convert.h"
+#include "unity.h"
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Conversion kernels must be bit-exact with the scalar reference.
+// No panel needed: these run on the bare target, and on the linux target in
+// host_test_app. Keep them to the C library and Unity.
+// ─────────────────────────────────────────────────────────────────────────────
+
+static const ili9486_conv_fn_t s_kernels[] = {
+    ili9486_rgb565_to_rgb666_word,
+    ili9486_rgb565_to_rgb666_lut,
+};
+
+#define SLICE_PIXELS 4096   // 65536 values in slices, to fit internal RAM
+#define GUARD        8
+
+/**
+ * Every RGB565 value, at every dst alignment and two src alignments.
+ */
+TEST_CASE("conversion kernels exhaustive 65536 values", "[ili9486][convert]")
+{
+    uint16_t *src = malloc((SLICE_PIXELS + 1) * 2);
+    uint8_t  *ref = malloc(SLICE_PIXELS * 3 + GUARD);
+    uint8_t  *out = malloc(SLICE_PIXELS * 3 + GUARD);
+    TEST_ASSERT_NOT_NULL(src);
+    TEST_ASSERT_NOT_NULL(ref);
+    TEST_ASSERT_NOT_NULL(out);
+
+    for (size_t k = 0; k < sizeof(s_kernels) / sizeof(s_kernels[0]); k++) {
+        for (uint32_t base = 0; base < 65536; base += SLICE_PIXELS) {
+            for (int src_off = 0; src_off < 2; src_off++) {
+                for (int i = 0; i < SLICE_PIXELS; i++) {
+                    src[src_off + i] = (uint16_t)(base + i);
+                }
+                for (int dst_off = 0; dst_off < 4; dst_off++) {
+                    memset(ref, 0xA5, SLICE_PIXELS * 3 + GUARD);
+                    memset(out, 0xA5, SLICE_PIXELS * 3 + GUARD);
+                    ili9486_rgb565_to_rgb666_ref(src + src_off, ref + dst_off, SLICE_PIXELS);
+                    s_kernels[k](src + src_off, out + dst_off, SLICE_PIXELS);
+                    TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(ref, out, SLICE_PIXELS * 3 + GUARD,
+                                                         ili9486_conv_name(s_kernels[k]));
+                }
+            }
+        }
+    }
+
+    free(src);
+    free(ref);
+    free(out);
+}
+
+/**
+ * Random pixels and short lengths, so head/tail handling and the bytes
+ * right after the output are covered too.
+ */
+TEST_CASE("conversion kernels random lengths", "[ili9486][convert]")
+{
+    uint16_t src[80];
+    uint8_t  ref[3 * 80 + GUARD];
+    uint8_t  out[3 * 80 + GUARD];
+
+    srand(0x9486);
+    for (int iter = 0; iter < 5000; iter++) {
+        size_t n       = rand() % 72;
+        int    src_off = rand() % 8;
+        int    dst_off = rand() % 4;
+        for (size_t i = 0; i < n; i++) {
+            src[src_off + i] = (uint16_t)rand();
+        }
+        for (size_t k = 0; k < sizeof(s_kernels) / sizeof(s_kernels[0]); k++) {
+            memset(ref, 0x5A, sizeof(ref));
+            memset(out, 0x5A, sizeof(out));
+            ili9486_rgb565_to_rgb666_ref(src + src_off, ref + dst_off, n);
+            s_kernels[k](src + src_off, out + dst_off, n);
+            TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(ref, out, sizeof(ref),
+                                                 ili9486_conv_name(s_kernels[k]));
+        }
+    }
+}
+
+/**
+ * The kernel the driver gets from ili9486_conv_select(), fed from odd
+ * source addresses and every destination offset, against the reference
+ * run on an aligned copy of the same pixels.
+ */
+TEST_CASE("selected kernel accepts any src and dst address", "[ili9486][convert]")
+{
+    ili9486_conv_fn_t conv = ili9486_conv_select();
+    uint16_t pixels[40];
+    uint16_t raw[42];                   // pixels again, 0..3 bytes further on
+    uint8_t  ref[3 * 40 + GUARD];
+    uint8_t  out[3 * 40 + 3 + GUARD];
+
+    srand(0x0565);
+    for (size_t i = 0; i < 40; i++) {
+        pixels[i] = (uint16_t)rand();
+    }
+    for (int src_off = 0; src_off < 4; src_off++) {
+        uint8_t *src = (uint8_t *)raw + src_off;
+        memcpy(src, pixels, sizeof(pixels));
+        for (int dst_off = 0; dst_off < 4; dst_off++) {
+            for (size_t n = 0; n <= 40; n++) {
+                memset(ref, 0x5A, sizeof(ref));
+                memset(out, 0x5A, sizeof(out));
+                ili9486_rgb565_to_rgb666_ref(pixels, ref, n);
+                conv((const uint16_t *)(void *)src, out + dst_off, n);
+                if (dst_off) {
+                    TEST_ASSERT_EACH_EQUAL_HEX8(0x5A, out, dst_off);
+                }
+                TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(ref, out + dst_off, sizeof(ref),
+                                                     ili9486_conv_name(conv));
+            }
+        }
+    }
+}
+
+/**
+ * The rotating kernel against rotate-then-convert, for all eight
+ * transforms, odd sizes with a padded stride, output bands that start
+ * and end mid-tile, and a source at an odd address.
+ */
+TEST_CASE("rotating kernel matches rotate then convert", "[ili9486][convert]")
+{
+    enum { W = 37, H = 23, STRIDE = 40 };
+    static uint16_t src[H * STRIDE];
+    static uint8_t  src_odd[H * STRIDE * 2 + 1];
+    static uint16_t rotated[W * H];
+    static uint8_t  ref[W * H * 3 + GUARD];
+    static uint8_t  out[W * H * 3 + GUARD];
+
+    srand(0x1486);
+    for (int i = 0; i < H * STRIDE; i++) {
+        src[i] = (uint16_t)rand();
+    }
+    memcpy(src_odd + 1, src, sizeof(src));
+
+    for (int xform = 0; xform < 8; xform++) {
+        const bool swap = xform & ILI9486_XFORM_SWAP_XY;
+        const int out_w = swap ? H : W;
+        const int out_h = swap ? W : H;
+        for (int y = 0; y < out_h; y++) {
+            for (int x = 0; x < out_w; x++) {
+                int ux = (xform & ILI9486_XFORM_MIRROR_X) ? out_w - 1 - x : x;
+                int uy = (xform & ILI9486_XFORM_MIRROR_Y) ? out_h - 1 - y : y;
+                rotated[y * out_w + x] = swap ? src[ux * STRIDE + uy] : src[uy * STRIDE + ux];
+            }
+        }
+        memset(ref, 0x5A, sizeof(ref));
+        ili9486_rgb565_to_rgb666_ref(rotated, ref, W * H);
+
+        for (int row = 0; row < out_h; row += 7) {
+            for (int src_off = 0; src_off < 2; src_off++) {
+                const uint16_t *in = src_off ? (const uint16_t *)(void *)(src_odd + 1) : src;
+                for (int dst_off = 0; dst_off < 4; dst_off++) {
+                    const int rows = out_h - row < 9 ? out_h - row : 9;
+                    memset(out, 0x5A, sizeof(out));
+                    ili9486_rgb565_to_rgb666_xform(in, STRIDE, W, H, xform, row, rows,
+                                                   out + dst_off);
+                    TEST_ASSERT_EQUAL_HEX8_ARRAY(ref + row * out_w * 3, out + dst_off,
+                                                 rows * out_w * 3);
+                    TEST_ASSERT_EACH_EQUAL_HEX8(0x5A, out + dst_off + rows * out_w * 3,
+                                                GUARD - 4);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Index expansion against a per-pixel palette lookup, for every index
+ * width and wire format, starting at every position within a byte.
+ */
+TEST_CASE("index expansion matches palette lookup", "[ili9486][convert]")
+{
+    uint32_t palette[256];
+    uint8_t  src[64];
+    uint8_t  ref[3 * 80 + GUARD];
+    uint8_t  out[3 * 80 + GUARD];
+
+    srand(0x1234);
+    for (int i = 0; i < 256; i++) {
+        palette[i] = (uint32_t)rand() & 0xFFFFFF;
+    }
+    for (size_t i = 0; i < sizeof(src); i++) {
+        src[i] = (uint8_t)rand();
+    }
+
+    for (int bits = 1; bits <= 8; bits *= 2) {
+        for (size_t bpp = 2; bpp <= 3; bpp++) {
+            for (int iter = 0; iter < 500; iter++) {
+                size_t first   = rand() % 16;
+                size_t n       = rand() % 48;
+                int    dst_off = rand() % 4;
+                memset(ref, 0x5A, sizeof(ref));
+                memset(out, 0x5A, sizeof(out));
+                for (size_t i = 0; i < n; i++) {
+                    size_t bit = (first + i) * bits;
+                    int idx = (src[bit / 8] >> (8 - bits - bit % 8)) & ((1 << bits) - 1);
+                    memcpy(ref + dst_off + i * bpp, &palette[idx], bpp);   // little-endian
+                }
+                ili9486_index_to_wire(src, first, bits, palette, bpp, out + dst_off, n);
+                TEST_ASSERT_EQUAL_HEX8_ARRAY(ref, out, sizeof(ref));
+            }
+        }
+    }
+}
@@ -0,0 +1,565 @@
+// Regression tests on the emulated panel IO: the driver runs unchanged on
+// top of esp_ili9486_mock_io, and GRAM is read back to check that every
+// pixel lands where it should, with no display attached.
+#include <string.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_ili9486_panel.h"
+#include "esp_ili9486_mock_io.h"
+#include "unity.h"
+
+#define LCD_W  320
+#define LCD_H  480
+#define BAND   40
+
+static esp_lcd_panel_io_handle_t s_io;
+
+static esp_lcd_panel_handle_t mock_panel_new_bpp(const ili9486_vendor_config_t *vendor, int bpp)
+{
+    esp_err_t ret = esp_lcd_new_panel_io_ili9486_mock(NULL, &s_io);
+    if (ret == ESP_ERR_NO_MEM) {
+        TEST_IGNORE_MESSAGE("no memory for the emulated GRAM (~460 KB)");
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+    const esp_lcd_panel_dev_config_t cfg = {
+        .reset_gpio_num = -1,
+        .bits_per_pixel = bpp,
+        .vendor_config  = (void *)vendor,
+    };
+    esp_lcd_panel_handle_t panel = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_ili9486(s_io, &cfg, &panel));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_reset(panel));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_init(panel));
+    return panel;
+}
+
+static esp_lcd_panel_handle_t mock_panel_new(const ili9486_vendor_config_t *vendor)
+{
+    return mock_panel_new_bpp(vendor, 16);
+}
+
+static void mock_panel_del(esp_lcd_panel_handle_t panel)
+{
+    esp_lcd_ili9486_mock_stats_t stats;
+    esp_lcd_ili9486_mock_get_stats(s_io, &stats);
+    TEST_ASSERT_EQUAL(0, stats.protocol_errors);
+    esp_lcd_panel_del(panel);
+    esp_lcd_panel_io_del(s_io);
+}
+
+// GRAM value the driver's RGB565 -> RGB666 conversion produces
+static void expect_666(uint16_t c, uint8_t rgb[3])
+{
+    rgb[0] = ((c >> 11) & 0x1F) << 1;
+    rgb[1] = (c >> 5) & 0x3F;
+    rgb[2] = (c & 0x1F) << 1;
+}
+
+static void assert_pixel(int x, int y, const uint8_t expect[3])
+{
+    uint8_t got[3];
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_mock_get_pixel(s_io, x, y, got));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expect, got, 3);
+}
+
+static void assert_pixel_565(int x, int y, uint16_t c)
+{
+    uint8_t rgb[3];
+    expect_666(c, rgb);
+    assert_pixel(x, y, rgb);
+}
+
+TEST_CASE("mock: init leaves the panel awake in RGB666", "[ili9486][mock]")
+{
+    esp_lcd_panel_handle_t panel = mock_panel_new(NULL);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_disp_on_off(panel, true));
+
+    esp_lcd_ili9486_mock_state_t st;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_mock_get_state(s_io, &st));
+    TEST_ASSERT_FALSE(st.sleeping);
+    TEST_ASSERT_TRUE(st.display_on);
+    TEST_ASSERT_EQUAL_HEX8(0x66, st.colmod);
+    TEST_ASSERT_FALSE(st.scrolling);
+    mock_panel_del(panel);
+}
+
+static const ili9486_lcd_init_cmd_t s_init_cmds[] = {
+    {0x11, 0, 0, NULL},
+    {0xC5, 2, 0, (const uint8_t[]){0x00, 0x18}},
+};
+
+TEST_CASE("mock: init runs step by step from the init table", "[ili9486][mock]")
+{
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_io_ili9486_mock(NULL, &s_io));
+    const esp_lcd_panel_dev_config_t cfg = {
+        .reset_gpio_num = -1,
+        .bits_per_pixel = 16,
+    };
+    esp_lcd_panel_handle_t panel = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_ili9486(s_io, &cfg, &panel));
+
+    // No hardware reset: SWRESET goes first, then nothing for 120 ms
+    esp_lcd_ili9486_mock_stats_t stats;
+    uint32_t wait_us = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_init_begin(panel));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FINISHED, esp_lcd_panel_ili9486_init_poll(panel, &wait_us));
+    TEST_ASSERT_GREATER_THAN(100 * 1000, wait_us);
+    TEST_ASSERT_LESS_OR_EQUAL(120 * 1000, wait_us);
+    esp_lcd_ili9486_mock_get_stats(s_io, &stats);
+    TEST_ASSERT_EQUAL(1, stats.cmd_count[0x01]);
+    TEST_ASSERT_EQUAL(0, stats.cmd_count[0x11]);
+
+    esp_err_t ret;
+    while ((ret = esp_lcd_panel_ili9486_init_poll(panel, &wait_us)) == ESP_ERR_NOT_FINISHED) {
+        vTaskDelay(1);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_init_poll(panel, NULL));
+    esp_lcd_ili9486_mock_state_t st;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_mock_get_state(s_io, &st));
+    TEST_ASSERT_FALSE(st.sleeping);
+    TEST_ASSERT_TRUE(st.display_on);
+    TEST_ASSERT_EQUAL_HEX8(0x66, st.colmod);
+    mock_panel_del(panel);
+
+    // A table of the application's replaces the driver's
+    const ili9486_vendor_config_t vendor = {
+        .init_cmds      = s_init_cmds,
+        .init_cmds_size = 2,
+    };
+    panel = mock_panel_new(&vendor);
+    esp_lcd_ili9486_mock_get_stats(s_io, &stats);
+    TEST_ASSERT_EQUAL(0, stats.cmd_count[0x01]);
+    TEST_ASSERT_EQUAL(0, stats.cmd_count[0xE0]);
+    TEST_ASSERT_EQUAL(1, stats.cmd_count[0xC5]);
+    TEST_ASSERT_EQUAL(1, stats.cmd_count[0x29]);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_mock_get_state(s_io, &st));
+    TEST_ASSERT_FALSE(st.sleeping);
+    mock_panel_del(panel);
+}
+
+TEST_CASE("mock: init queues the table entries with parameters", "[ili9486][mock]")
+{
+    // Only SWRESET, SLPOUT and DISPON, which have no parameters, block in
+    // tx_param(); the ten register writes go out fused with their
+    // parameters, as COLMOD and MADCTL do, in either parameter width.
+    for (int params_8bit = 0; params_8bit < 2; params_8bit++) {
+        const ili9486_vendor_config_t vendor = {
+            .flags.params_8bit = params_8bit,
+        };
+        esp_lcd_panel_handle_t panel = mock_panel_new(&vendor);
+        esp_lcd_ili9486_mock_stats_t stats;
+        esp_lcd_ili9486_mock_get_stats(s_io, &stats);
+        TEST_ASSERT_EQUAL(3, stats.tx_param_calls);
+        TEST_ASSERT_EQUAL(10 + 2, stats.tx_color_calls);
+        TEST_ASSERT_EQUAL(1, stats.cmd_count[0xE1]);
+        // 42 table parameters, then the single COLMOD and MADCTL bytes
+        TEST_ASSERT_EQUAL((params_8bit ? 42 : 2 * 42) + 2, stats.param_bytes);
+        mock_panel_del(panel);
+    }
+}
+
+// 3 x 2 splash on blue: red red green / green green green
+static const uint8_t s_splash[] = {
+    'I', 'S', 'P', 'L', 1, 0x01, 3, 0, 2, 0, 0x1F, 0x00,
+    2, 0, 0x00, 0xF8, 0xE0, 0x07,           // palette: red, green
+    0x81, 0x00,                             // run of 2 x red
+    0x00, 0x01,                             // literal: green
+    0x82, 0x01,                             // run of 3 x green
+};
+
+TEST_CASE("mock: init writes the boot splash before DISPON", "[ili9486][mock]")
+{
+    ili9486_vendor_config_t vendor = {
+        .splash      = s_splash,
+        .splash_size = sizeof(s_splash),
+    };
+    esp_lcd_panel_handle_t panel = mock_panel_new(&vendor);
+
+    // Centred on a 320 x 480 screen: the image starts at (158, 239)
+    const uint16_t image[2][3] = {
+        {0xF800, 0xF800, 0x07E0},
+        {0x07E0, 0x07E0, 0x07E0},
+    };
+    for (int y = 238; y < 242; y++) {
+        for (int x = 157; x < 162; x++) {
+            bool in = x >= 158 && x < 161 && y >= 239 && y < 241;
+            assert_pixel_565(x, y, in ? image[y - 239][x - 158] : 0x001F);
+        }
+    }
+    assert_pixel_565(0, 0, 0x001F);
+    assert_pixel_565(LCD_W - 1, LCD_H - 1, 0x001F);
+    esp_lcd_ili9486_mock_state_t st;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_mock_get_state(s_io, &st));
+    TEST_ASSERT_TRUE(st.display_on);
+    mock_panel_del(panel);
+
+    // A bad header is refused up front, a truncated image by init
+    const esp_lcd_panel_dev_config_t cfg = {
+        .reset_gpio_num = -1,
+        .bits_per_pixel = 16,
+        .vendor_config  = &vendor,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_io_ili9486_mock(NULL, &s_io));
+    vendor.splash = "not a splash image";
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_new_panel_ili9486(s_io, &cfg, &panel));
+    vendor.splash      = s_splash;
+    vendor.splash_size = sizeof(s_splash) - 1;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_ili9486(s_io, &cfg, &panel));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, esp_lcd_panel_init(panel));
+    esp_lcd_panel_del(panel);
+    esp_lcd_panel_io_del(s_io);
+}
+
+TEST_CASE("mock: a bad vendor config fails panel creation", "[ili9486][mock]")
+{
+    ili9486_vendor_config_t vendor = {
+        .coalesce.max_rects = 33,
+    };
+    const esp_lcd_panel_dev_config_t cfg = {
+        .reset_gpio_num = -1,
+        .bits_per_pixel = 16,
+        .vendor_config  = &vendor,
+    };
+    esp_lcd_panel_handle_t panel = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_io_ili9486_mock(NULL, &s_io));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_new_panel_ili9486(s_io, &cfg, &panel));
+
+    // Refused before the TE pin is set up, which must then be left alone
+    vendor.coalesce.max_rects = 0;
+    vendor.flags.te_enable    = 1;
+    vendor.te_gpio_num        = 4;
+    vendor.splash             = "not a splash image";
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_new_panel_ili9486(s_io, &cfg, &panel));
+    TEST_ASSERT_NULL(panel);
+    esp_lcd_panel_io_del(s_io);
+}
+
+TEST_CASE("mock: draw_bitmap is bit-exact in GRAM", "[ili9486][mock]")
+{
+    uint16_t *frame = heap_caps_malloc(LCD_W * LCD_H * sizeof(uint16_t), MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(frame);
+    for (int i = 0; i < LCD_W * LCD_H; i++) frame[i] = rand();
+    esp_lcd_panel_handle_t panel = mock_panel_new(NULL);
+
+    esp_lcd_ili9486_mock_reset_stats(s_io);
+    for (int y = 0; y < LCD_H; y += BAND) {
+        esp_lcd_panel_draw_bitmap(panel, 0, y, LCD_W, y + BAND, frame + y * LCD_W);
+    }
+    esp_lcd_panel_disp_on_off(panel, true);     // drains the converter task, if enabled
+    for (int y = 0; y < LCD_H; y++) {
+        for (int x = 0; x < LCD_W; x++) {
+            assert_pixel_565(x, y, frame[y * LCD_W + x]);
+        }
+    }
+    esp_lcd_ili9486_mock_stats_t stats;
+    esp_lcd_ili9486_mock_get_stats(s_io, &stats);
+    TEST_ASSERT_EQUAL(LCD_W * LCD_H, stats.pixels);
+    TEST_ASSERT_EQUAL(LCD_W * LCD_H * 3, stats.pixel_bytes);
+
+    // An odd-sized window leaves its surroundings alone
+    static uint16_t patch[17 * 29];
+    for (int i = 0; i < 17 * 29; i++) patch[i] = rand();
+    esp_lcd_panel_draw_bitmap(panel, 37, 53, 37 + 29, 53 + 17, patch);
+    esp_lcd_panel_disp_on_off(panel, true);
+    for (int y = 52; y < 53 + 18; y++) {
+        for (int x = 36; x < 37 + 30; x++) {
+            bool in = x >= 37 && x < 37 + 29 && y >= 53 && y < 53 + 17;
+            assert_pixel_565(x, y, in ? patch[(y - 53) * 29 + x - 37] : frame[y * LCD_W + x]);
+        }
+    }
+
+    mock_panel_del(panel);
+    free(frame);
+}
+
+TEST_CASE("mock: mirror, swap and fill map to GRAM", "[ili9486][mock]")
+{
+    esp_lcd_panel_handle_t panel = mock_panel_new(NULL);
+    const uint16_t red = 0xF800, green = 0x07E0, blue = 0x001F;
+
+    // Mirrored X: screen (0,0) is the panel's top right pixel
+    esp_lcd_panel_mirror(panel, true, false);
+    esp_lcd_panel_draw_bitmap(panel, 0, 0, 1, 1, &red);
+    // Swapped: screen x runs down the panel, screen y across it
+    esp_lcd_panel_mirror(panel, false, false);
+    esp_lcd_panel_swap_xy(panel, true);
+    esp_lcd_panel_draw_bitmap(panel, 10, 2, 11, 3, &green);
+    esp_lcd_panel_swap_xy(panel, false);
+    esp_lcd_panel_ili9486_fill_rect(panel, 100, 200, 116, 208, blue);
+    esp_lcd_panel_disp_on_off(panel, true);
+
+    assert_pixel_565(LCD_W - 1, 0, red);
+    assert_pixel_565(2, 10, green);
+    assert_pixel_565(100, 200, blue);
+    assert_pixel_565(115, 207, blue);
+    assert_pixel_565(116, 207, 0);
+    assert_pixel_565(115, 208, 0);
+    mock_panel_del(panel);
+}
+
+TEST_CASE("mock: set_orientation rotates in one MADCTL write", "[ili9486][mock]")
+{
+    esp_lcd_panel_handle_t panel = mock_panel_new(NULL);
+    const uint16_t red = 0xF800, green = 0x07E0;
+    // Expected MADCTL, logical size, and the GRAM position of the
+    // screen's top left and bottom right pixels
+    const struct {
+        uint8_t madctl;
+        int w, h;
+        int x0, y0, x1, y1;
+    } o[] = {
+        [ILI9486_ORIENTATION_0]   = { 0x48, LCD_W, LCD_H, LCD_W - 1, 0, 0, LCD_H - 1 },
+        [ILI9486_ORIENTATION_90]  = { 0xE8, LCD_H, LCD_W, LCD_W - 1, LCD_H - 1, 0, 0 },
+        [ILI9486_ORIENTATION_180] = { 0x88, LCD_W, LCD_H, 0, LCD_H - 1, LCD_W - 1, 0 },
+        [ILI9486_ORIENTATION_270] = { 0x28, LCD_H, LCD_W, 0, 0, LCD_W - 1, LCD_H - 1 },
+    };
+
+    for (int i = 0; i < sizeof(o) / sizeof(o[0]); i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_set_orientation(panel, i));
+        esp_lcd_panel_draw_bitmap(panel, 0, 0, 1, 1, &red);
+        esp_lcd_panel_draw_bitmap(panel, o[i].w - 1, o[i].h - 1, o[i].w, o[i].h, &green);
+        esp_lcd_panel_disp_on_off(panel, true);
+
+        esp_lcd_ili9486_mock_state_t st;
+        esp_lcd_ili9486_mock_get_state(s_io, &st);
+        TEST_ASSERT_EQUAL_HEX8(o[i].madctl, st.madctl);
+        assert_pixel_565(o[i].x0, o[i].y0, red);
+        assert_pixel_565(o[i].x1, o[i].y1, green);
+    }
+
+    // The gaps follow the panel axes: a column gap in portrait is a row
+    // gap in landscape, and lands on the same GRAM column
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_set_orientation(panel, ILI9486_ORIENTATION_0));
+    esp_lcd_panel_set_gap(panel, 8, 0);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_set_orientation(panel, ILI9486_ORIENTATION_90));
+    esp_lcd_panel_draw_bitmap(panel, 0, 0, 1, 1, &green);
+    esp_lcd_panel_disp_on_off(panel, true);
+    assert_pixel_565(LCD_W - 1 - 8, LCD_H - 1, green);
+
+    // swap_xy() and mirror() reaching the same MADCTL give the same window,
+    // as lvgl_port does before ili9486_display_set_rotation() catches up
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_set_orientation(panel, ILI9486_ORIENTATION_0));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_swap_xy(panel, true));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_mirror(panel, true, true));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_set_orientation(panel, ILI9486_ORIENTATION_90));
+    esp_lcd_panel_draw_bitmap(panel, 1, 0, 2, 1, &red);
+    esp_lcd_panel_disp_on_off(panel, true);
+    assert_pixel_565(LCD_W - 1 - 8, LCD_H - 2, red);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_swap_xy(panel, false));
+    esp_lcd_panel_draw_bitmap(panel, 0, 0, 1, 1, &red);
+    esp_lcd_panel_disp_on_off(panel, true);
+    assert_pixel_565(LCD_W - 1 - 8, LCD_H - 1, red);
+
+    // Rotated orientations need the row order scrolling relies on
+    esp_lcd_panel_set_gap(panel, 0, 0);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_set_orientation(panel, ILI9486_ORIENTATION_0));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_scroll_define(panel, 0, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE,
+                      esp_lcd_panel_ili9486_set_orientation(panel, ILI9486_ORIENTATION_180));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_panel_ili9486_set_orientation(panel, 4));
+    mock_panel_del(panel);
+}
+
+// FNV-1a hash of each GRAM row
+static void gram_row_hashes(uint32_t hash[LCD_H])
+{
+    for (int y = 0; y < LCD_H; y++) {
+        hash[y] = 2166136261u;
+        for (int x = 0; x < LCD_W; x++) {
+            uint8_t rgb[3];
+            esp_lcd_ili9486_mock_get_pixel(s_io, x, y, rgb);
+            for (int i = 0; i < 3; i++) {
+                hash[y] = (hash[y] ^ rgb[i]) * 16777619u;
+            }
+        }
+    }
+}
+
+TEST_CASE("mock: sw_orientation matches the MADCTL rotation", "[ili9486][mock]")
+{
+    enum { W = 100, H = 23 };
+    static uint16_t bitmap[H * W];
+    static uint32_t hash[2][LCD_H];
+    for (int i = 0; i < H * W; i++) bitmap[i] = rand();
+    // A chunk narrower than the area, so it goes out in several windows
+    const ili9486_vendor_config_t sw = {
+        .conv_buf_pixels      = 64,
+        .flags.sw_orientation = 1,
+    };
+
+    for (int o = ILI9486_ORIENTATION_0; o <= ILI9486_ORIENTATION_270; o++) {
+        for (int soft = 0; soft < 2; soft++) {
+            esp_lcd_panel_handle_t panel = mock_panel_new(soft ? &sw : NULL);
+            TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_set_orientation(panel, o));
+            TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_fill_rect(panel, 2, 3, 50, 9, 0x07E0));
+            esp_lcd_panel_draw_bitmap(panel, 5, 7, 5 + W, 7 + H, bitmap);
+            esp_lcd_panel_disp_on_off(panel, true);
+            esp_lcd_ili9486_mock_state_t st;
+            esp_lcd_ili9486_mock_get_state(s_io, &st);
+            if (soft) {
+                TEST_ASSERT_EQUAL_HEX8(0x48, st.madctl);
+            }
+            gram_row_hashes(hash[soft]);
+            if (soft && o != ILI9486_ORIENTATION_0) {
+                static const uint8_t indices[1];
+                static ili9486_palette_t palette;
+                TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_palette_init(panel, bitmap, 2,
+                                                                             &palette));
+                TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, esp_lcd_panel_ili9486_draw_indexed(
+                                      panel, 0, 0, 8, 1, indices, 1, &palette));
+                TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, esp_lcd_panel_ili9486_begin_frame(panel));
+            }
+            mock_panel_del(panel);
+        }
+        TEST_ASSERT_EQUAL_HEX32_ARRAY(hash[0], hash[1], LCD_H);
+    }
+}
+
+TEST_CASE("mock: scrolled draws land at their screen position", "[ili9486][mock]")
+{
+    esp_lcd_panel_handle_t panel = mock_panel_new(NULL);
+    static uint16_t row[LCD_W];
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_scroll_define(panel, 40, 60));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_scroll_to(panel, 100));
+    for (int y = 0; y < LCD_H; y += 8) {
+        for (int x = 0; x < LCD_W; x++) row[x] = y * 131 + x;
+        esp_lcd_panel_draw_bitmap(panel, 0, y, LCD_W, y + 1, row);
+        esp_lcd_panel_disp_on_off(panel, true);
+        for (int x = 0; x < LCD_W; x += 7) {
+            assert_pixel_565(x, y, row[x]);
+        }
+    }
+
+    esp_lcd_ili9486_mock_state_t st;
+    esp_lcd_ili9486_mock_get_state(s_io, &st);
+    TEST_ASSERT_TRUE(st.scrolling);
+    TEST_ASSERT_EQUAL(40, st.top_fixed);
+    TEST_ASSERT_EQUAL(380, st.scroll_lines);
+    TEST_ASSERT_EQUAL(140, st.scroll_start);
+    esp_lcd_panel_ili9486_scroll_stop(panel);
+    mock_panel_del(panel);
+}
+
+TEST_CASE("mock: native RGB565 goes out big-endian", "[ili9486][mock]")
+{
+    const ili9486_vendor_config_t vendor = {
+        .pixel_format = ILI9486_PIXEL_FORMAT_RGB565,
+    };
+    esp_lcd_panel_handle_t panel = mock_panel_new(&vendor);
+    // Sent as stored, so the buffer holds byte-swapped colours
+    static const uint16_t px[2] = { 0x00F8, 0x1F00 };   // red, blue
+    esp_lcd_panel_draw_bitmap(panel, 0, 0, 2, 1, px);
+    esp_lcd_panel_disp_on_off(panel, true);
+
+    // 5-bit channels widen by repeating their top bit
+    assert_pixel(0, 0, (const uint8_t[3]){ 0x3F, 0, 0 });
+    assert_pixel(1, 0, (const uint8_t[3]){ 0, 0, 0x3F });
+    esp_lcd_ili9486_mock_state_t st;
+    esp_lcd_ili9486_mock_get_state(s_io, &st);
+    TEST_ASSERT_EQUAL_HEX8(0x55, st.colmod);
+    mock_panel_del(panel);
+}
+
+TEST_CASE("mock: 24 bpp input shows the colours 16 bpp does", "[ili9486][mock]")
+{
+    static const uint16_t colors[4] = { 0xF800, 0x07E0, 0x001F, 0x8A6D };
+    static ili9486_palette_t palette;
+    const ili9486_vendor_config_t vendor = {
+        .splash      = s_splash,
+        .splash_size = sizeof(s_splash),
+    };
+    // LVGL's RGB888: B, G, R in memory, zero-copy so in DMA-capable RAM
+    uint8_t *rgb888 = heap_caps_malloc(4 * 3, MALLOC_CAP_DMA);
+    TEST_ASSERT_NOT_NULL(rgb888);
+    for (int i = 0; i < 4; i++) {
+        rgb888[3 * i + 0] = (colors[i] & 0x1F) << 3;
+        rgb888[3 * i + 1] = ((colors[i] >> 5) & 0x3F) << 2;
+        rgb888[3 * i + 2] = (colors[i] >> 11) << 3;
+    }
+    static const uint8_t indices[1] = { 0x1B };     // 0, 1, 2, 3 at 2 bits
+
+    for (int bpp = 16; bpp <= 24; bpp += 8) {
+        esp_lcd_panel_handle_t panel = mock_panel_new_bpp(&vendor, bpp);
+        esp_lcd_panel_draw_bitmap(panel, 0, 0, 4, 1, bpp == 16 ? (const void *)colors : rgb888);
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_fill_rect(panel, 0, 1, 4, 2, colors[3]));
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_palette_init(panel, colors, 4, &palette));
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_draw_indexed(panel, 0, 2, 4, 3, indices, 2,
+                                                                     &palette));
+        esp_lcd_panel_disp_on_off(panel, true);
+        for (int x = 0; x < 4; x++) {
+            assert_pixel_565(x, 0, colors[x]);
+            assert_pixel_565(x, 1, colors[3]);
+            assert_pixel_565(x, 2, colors[x]);
+        }
+        assert_pixel_565(158, 239, 0xF800);         // splash image and background
+        assert_pixel_565(LCD_W - 1, LCD_H - 1, 0x001F);
+        mock_panel_del(panel);
+    }
+
+    // 18 bpp has no packed in-memory format to take
+    const esp_lcd_panel_dev_config_t cfg = {
+        .reset_gpio_num = -1,
+        .bits_per_pixel = 18,
+    };
+    esp_lcd_panel_handle_t panel = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_io_ili9486_mock(NULL, &s_io));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_new_panel_ili9486(s_io, &cfg, &panel));
+    esp_lcd_panel_io_del(s_io);
+    free(rgb888);
+}
+
+TEST_CASE("mock: indexed draws expand through the palette", "[ili9486][mock]")
+{
+    enum { W = 37, H = 30 };    // odd rows, and more than one chunk
+    static uint16_t colors[256];
+    static uint8_t indices[H * W];
+    static ili9486_palette_t palette;
+    for (int i = 0; i < 256; i++) colors[i] = rand();
+    for (int i = 0; i < sizeof(indices); i++) indices[i] = rand();
+
+    for (int native = 0; native < 2; native++) {
+        const ili9486_vendor_config_t vendor = {
+            .pixel_format = native ? ILI9486_PIXEL_FORMAT_RGB565 : ILI9486_PIXEL_FORMAT_RGB666,
+        };
+        esp_lcd_panel_handle_t panel = mock_panel_new(&vendor);
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_palette_init(panel, colors, 256, &palette));
+
+        for (int bits = 1; bits <= 8; bits *= 2) {
+            const int x0 = bits * 20, y0 = bits * 40;
+            TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_draw_indexed(panel, x0, y0, x0 + W,
+                                                                         y0 + H, indices, bits,
+                                                                         &palette));
+            esp_lcd_panel_disp_on_off(panel, true);
+            const int row_bytes = (W * bits + 7) / 8;
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    int bit = x * bits;
+                    int idx = (indices[y * row_bytes + bit / 8] >> (8 - bits - bit % 8)) &
+                              ((1 << bits) - 1);
+                    uint16_t c = colors[idx];
+                    uint8_t rgb[3];
+                    expect_666(c, rgb);
+                    if (native) {
+                        // 5-bit channels widen by repeating their top bit
+                        rgb[0] |= rgb[0] >> 5;
+                        rgb[2] |= rgb[2] >> 5;
+                    }
+                    assert_pixel(x0 + x, y0 + y, rgb);
+                }
+            }
+        }
+
+        // A palette converted for the other pixel format is refused
+        palette.bytes_per_pixel = native ? 3 : 2;
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, esp_lcd_panel_ili9486_draw_indexed(
+                              panel, 0, 0, W, H, indices, 8, &palette));
+        mock_panel_del(panel);
+    }
+}
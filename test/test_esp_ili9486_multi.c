@@ -0,0 +1,187 @@
+// Multi-panel tests on two emulated panels: span draws land on the right
+// panel at the right place, and a bus group flushes every member.
+#include <string.h>
+#include <stdlib.h>
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_ili9486_panel.h"
+#include "esp_ili9486_multi.h"
+#include "esp_ili9486_mock_io.h"
+#include "unity.h"
+
+#define LCD_W    320
+#define LCD_H    480
+#define PATCH_W  60
+#define PATCH_H  40
+
+static esp_lcd_panel_io_handle_t s_io[2];
+static esp_lcd_panel_handle_t s_panel[2];
+static uint16_t s_patch[PATCH_W * PATCH_H];
+static volatile int s_released;
+
+static void multi_panels_new(void)
+{
+    for (int i = 0; i < 2; i++) {
+        esp_err_t ret = esp_lcd_new_panel_io_ili9486_mock(NULL, &s_io[i]);
+        if (ret == ESP_ERR_NO_MEM) {
+            TEST_IGNORE_MESSAGE("no memory for two emulated GRAMs (~920 KB)");
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, ret);
+
+        const esp_lcd_panel_dev_config_t cfg = {
+            .reset_gpio_num = -1,
+            .bits_per_pixel = 16,
+        };
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_ili9486(s_io[i], &cfg, &s_panel[i]));
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_reset(s_panel[i]));
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_init(s_panel[i]));
+    }
+    for (int i = 0; i < PATCH_W * PATCH_H; i++) s_patch[i] = rand();
+}
+
+static void multi_panels_del(void)
+{
+    for (int i = 0; i < 2; i++) {
+        esp_lcd_panel_del(s_panel[i]);
+        esp_lcd_panel_io_del(s_io[i]);
+    }
+}
+
+static void assert_pixel_565(int panel, int x, int y, uint16_t c)
+{
+    const uint8_t expect[3] = {
+        ((c >> 11) & 0x1F) << 1, (c >> 5) & 0x3F, (c & 0x1F) << 1,
+    };
+    uint8_t got[3];
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_mock_get_pixel(s_io[panel], x, y, got));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expect, got, 3);
+}
+
+// s_patch drawn at (x0, y0) on the span surface, checked on the panels
+static void assert_span_patch(ili9486_span_layout_t layout, int x0, int y0)
+{
+    for (int y = y0; y < y0 + PATCH_H; y++) {
+        for (int x = x0; x < x0 + PATCH_W; x++) {
+            int p = layout == ILI9486_SPAN_HORIZONTAL ? x / LCD_W : y / LCD_H;
+            assert_pixel_565(p, x % LCD_W, y % LCD_H, s_patch[(y - y0) * PATCH_W + x - x0]);
+        }
+    }
+}
+
+static bool on_src_released(esp_lcd_panel_handle_t panel, void *user_ctx)
+{
+    s_released++;
+    return false;
+}
+
+TEST_CASE("multi: span draws are split at the panel edges", "[ili9486][multi]")
+{
+    multi_panels_new();
+    const struct {
+        ili9486_span_layout_t layout;
+        int x, y;
+    } draws[] = {
+        { ILI9486_SPAN_HORIZONTAL, LCD_W - PATCH_W / 2, 100 },     // across the seam
+        { ILI9486_SPAN_HORIZONTAL, 2 * LCD_W - PATCH_W, 0 },       // right panel only
+        { ILI9486_SPAN_VERTICAL,   10, LCD_H - PATCH_H / 4 },      // across the seam
+        { ILI9486_SPAN_VERTICAL,   LCD_W - PATCH_W, 2 * LCD_H - PATCH_H },
+    };
+
+    for (int i = 0; i < sizeof(draws) / sizeof(draws[0]); i++) {
+        const esp_lcd_ili9486_span_config_t span_config = {
+            .panels      = { s_panel[0], s_panel[1] },
+            .panel_count = 2,
+            .layout      = draws[i].layout,
+        };
+        esp_lcd_panel_handle_t span = NULL;
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_ili9486_span(&span_config, &span));
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_draw_bitmap(span, draws[i].x, draws[i].y,
+                                                            draws[i].x + PATCH_W,
+                                                            draws[i].y + PATCH_H, s_patch));
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_disp_on_off(span, true));   // drains both
+        assert_span_patch(draws[i].layout, draws[i].x, draws[i].y);
+        TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, esp_lcd_panel_swap_xy(span, true));
+        esp_lcd_panel_del(span);
+    }
+    multi_panels_del();
+}
+
+TEST_CASE("multi: span releases each draw once", "[ili9486][multi]")
+{
+    multi_panels_new();
+    const esp_lcd_ili9486_span_config_t span_config = {
+        .panels      = { s_panel[0], s_panel[1] },
+        .panel_count = 2,
+        .layout      = ILI9486_SPAN_HORIZONTAL,
+    };
+    esp_lcd_panel_handle_t span = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_ili9486_span(&span_config, &span));
+    esp_lcd_panel_ili9486_callbacks_t cbs = {
+        .on_flush_done = on_src_released,
+    };
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED,
+                      esp_lcd_panel_ili9486_span_register_event_callbacks(span, &cbs, NULL));
+    cbs = (esp_lcd_panel_ili9486_callbacks_t) {
+        .on_src_released = on_src_released,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_span_register_event_callbacks(span, &cbs, NULL));
+    s_released = 0;
+
+    // Both panels, one panel each, and off the surface
+    for (int i = 0; i < 50; i++) {
+        int x = (i % 5) * (2 * LCD_W / 5) - PATCH_W / 2;
+        esp_lcd_panel_draw_bitmap(span, x, i * 8, x + PATCH_W, i * 8 + PATCH_H, s_patch);
+    }
+    esp_lcd_panel_draw_bitmap(span, 0, LCD_H, PATCH_W, LCD_H + PATCH_H, s_patch);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_disp_on_off(span, true));
+    TEST_ASSERT_EQUAL(51, s_released);
+
+    esp_lcd_panel_del(span);
+    multi_panels_del();
+}
+
+TEST_CASE("multi: bus group flushes every member", "[ili9486][multi]")
+{
+    const esp_lcd_ili9486_bus_group_config_t group_config = {
+        .sched = ILI9486_BUS_SCHED_ROUND_ROBIN,
+    };
+    esp_lcd_ili9486_bus_group_handle_t group = NULL;
+#if !CONFIG_ILI9486_CONVERTER_TASK
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_SUPPORTED, esp_lcd_ili9486_bus_group_new(&group_config, &group));
+#else
+    multi_panels_new();
+    for (int sched = ILI9486_BUS_SCHED_ROUND_ROBIN; sched <= ILI9486_BUS_SCHED_DEADLINE; sched++) {
+        const esp_lcd_ili9486_bus_group_config_t config = { .sched = sched };
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_bus_group_new(&config, &group));
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_bus_group_add_panel(group, s_panel[0], 16000));
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_bus_group_add_panel(group, s_panel[1], 33000));
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE,
+                          esp_lcd_ili9486_bus_group_add_panel(group, s_panel[1], 0));
+
+        for (int y = 0; y + PATCH_H <= LCD_H; y += PATCH_H) {
+            for (int i = 0; i < 2; i++) {
+                esp_lcd_panel_draw_bitmap(s_panel[i], i * 100, y, i * 100 + PATCH_W,
+                                          y + PATCH_H, s_patch);
+            }
+        }
+        for (int i = 0; i < 2; i++) {
+            TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_disp_on_off(s_panel[i], true));
+            for (int y = 0; y < LCD_H; y++) {
+                for (int x = i * 100; x < i * 100 + PATCH_W; x++) {
+                    assert_pixel_565(i, x, y, s_patch[(y % PATCH_H) * PATCH_W + x - i * 100]);
+                }
+            }
+        }
+
+        // Panel 0 gets a task of its own back, panel 1 leaves with the group
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_bus_group_remove_panel(group, s_panel[0]));
+        esp_lcd_panel_draw_bitmap(s_panel[0], 0, 0, PATCH_W, PATCH_H, s_patch);
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_disp_on_off(s_panel[0], true));
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_ili9486_bus_group_del(group));
+        esp_lcd_panel_draw_bitmap(s_panel[1], 0, 0, PATCH_W, PATCH_H, s_patch);
+        TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_disp_on_off(s_panel[1], true));
+        assert_pixel_565(1, PATCH_W - 1, PATCH_H - 1, s_patch[PATCH_H * PATCH_W - 1]);
+    }
+    multi_panels_del();
+#endif
+}
@@ -6,7 +6,9 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "esp_log.h"
+#include "esp_heap_caps.h"
 #include "esp_lcd_panel_ops.h"
+#include "esp_ili9486_panel.h"
 #include "panel_init.h"   // your existing display init header
 #include "unity.h"
 
@@ -33,16 +35,12 @@ static const char* TAG = "test_panel";
 static uint16_t row_buf[LCD_W];
 
 // ── Fill a rectangle with a solid colour ─────────────────────────────────────
+// Inclusive corners; the driver fill streams a pattern, no row buffer needed
 static void fill_rect(esp_lcd_panel_handle_t panel,
                       int x0, int y0, int x1, int y1,
                       uint16_t colour)
 {
-    int w = x1 - x0 + 1;
-    for (int i = 0; i < w; i++) row_buf[i] = colour;
-
-    for (int y = y0; y <= y1; y++) {
-        esp_lcd_panel_draw_bitmap(panel, x0, y, x1 + 1, y + 1, row_buf);
-    }
+    esp_lcd_panel_ili9486_fill_rect(panel, x0, y0, x1 + 1, y1 + 1, colour);
 }
 
 // ── Fill entire screen ────────────────────────────────────────────────────────
@@ -257,4 +255,123 @@ TEST_CASE("full screen gradient", "[ili9486]")
     ESP_LOGI(TAG, "  Banding      -> RASET byte ordering issue");
     ESP_LOGI(TAG, "  Wrong colour -> BGR/RGB in rgb565_to_rgb666");
     TEST_PASS();
-}
\ No newline at end of file
+}
+
+/**
+ * TEST 7 — Window command cache
+ *
+ * Fills the screen row by row. Every row shares the column range, so
+ * only the first row may send CASET; RASET changes on every row.
+ *
+ * Pass: LCD_H - 1 CASET commands skipped, screen fully green
+ * Fail (count):  window cache not reused or not tracked per axis
+ * Fail (visual): skipped command left a stale window behind
+ */
+TEST_CASE("window cache skips unchanged CASET", "[ili9486]")
+{
+    esp_lcd_panel_handle_t panel = ili9486_display_get_panel();
+    TEST_ASSERT_NOT_NULL(panel);
+
+    esp_lcd_panel_ili9486_stats_t before, after;
+    fill_rect(panel, 0, 0, 0, 0, BLACK);   // leave a different column range programmed
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_get_stats(panel, &before));
+    for (int x = 0; x < LCD_W; x++) row_buf[x] = GREEN;
+    for (int y = 0; y < LCD_H; y++) {
+        esp_lcd_panel_draw_bitmap(panel, 0, y, LCD_W, y + 1, row_buf);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_get_stats(panel, &after));
+    TEST_ASSERT_EQUAL_UINT32(LCD_H - 1,
+                             after.window_cmds_skipped - before.window_cmds_skipped);
+    vTaskDelay(pdMS_TO_TICKS(2000));
+
+    ESP_LOGI(TAG, "VISUAL CHECK: Full screen green");
+    TEST_PASS();
+}
+
+/**
+ * TEST 8 — Hardware vertical scroll
+ *
+ * Fixes a 40-row RED header and a 40-row BLUE footer, fills the area in
+ * between with horizontal bands and scrolls it one full turn, drawing the
+ * newly exposed bottom row in WHITE every 40 steps.
+ *
+ * Pass: header/footer stay still, bands roll up smoothly, white lines
+ *       appear at the bottom of the scroll area and move up with it
+ * Fail (whole screen moves):  VSCRDEF fixed areas wrong
+ * Fail (white lines jump):    logical row remapping wrong
+ */
+TEST_CASE("hardware vertical scroll", "[ili9486]")
+{
+    esp_lcd_panel_handle_t panel = ili9486_display_get_panel();
+    TEST_ASSERT_NOT_NULL(panel);
+
+    const int top = 40, bottom = 40, lines = LCD_H - top - bottom;
+    const uint16_t bands[] = { GREEN, YELLOW, CYAN, MAGENTA };
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_scroll_define(panel, top, bottom));
+    fill_rect(panel, 0, 0, LCD_W - 1, top - 1, RED);
+    fill_rect(panel, 0, LCD_H - bottom, LCD_W - 1, LCD_H - 1, BLUE);
+    for (int i = 0; i < 4; i++) {
+        fill_rect(panel, 0, top + i * lines / 4, LCD_W - 1, top + (i + 1) * lines / 4 - 1, bands[i]);
+    }
+
+    for (int offset = 1; offset <= lines; offset++) {
+        TEST_ASSERT_EQUAL(ESP_OK,
+                          esp_lcd_panel_ili9486_scroll_to(panel, offset % lines));
+        if (offset % 40 == 0) {
+            fill_rect(panel, 0, top + lines - 1, LCD_W - 1, top + lines - 1, WHITE);
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_scroll_stop(panel));
+
+    ESP_LOGI(TAG, "VISUAL CHECK: bands scrolled between fixed red/blue bars");
+    TEST_PASS();
+}
+
+/**
+ * TEST 9 — Dirty-rectangle coalescing
+ *
+ * Draws the screen as 16 full-width 30-row bands inside one frame, all
+ * from the same band buffer (a red->blue ramp). Stacked bands cover
+ * their bounding box, so end_frame() sends them as a single window.
+ *
+ * Pass: 16 rectangles in, 1 window out, 16 identical ramps on screen
+ * Fail (count):  coalescer did not merge adjacent rectangles
+ * Fail (visual): rows taken from the wrong rectangle or offset
+ */
+TEST_CASE("coalesced frame merges stacked bands", "[ili9486]")
+{
+    esp_lcd_panel_handle_t panel = ili9486_display_get_panel();
+    TEST_ASSERT_NOT_NULL(panel);
+
+    const int band = LCD_H / 16;
+    uint16_t *buf = heap_caps_malloc(LCD_W * band * sizeof(uint16_t), MALLOC_CAP_DMA);
+    TEST_ASSERT_NOT_NULL(buf);
+    for (int y = 0; y < band; y++) {
+        uint16_t c = RGB565(255 - y * 255 / band, 0, y * 255 / band);
+        for (int x = 0; x < LCD_W; x++) buf[y * LCD_W + x] = c;
+    }
+
+    esp_lcd_panel_ili9486_stats_t before, after;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_get_stats(panel, &before));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_begin_frame(panel));
+    for (int i = 0; i < 16; i++) {
+        esp_lcd_panel_draw_bitmap(panel, 0, i * band, LCD_W, (i + 1) * band, buf);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_end_frame(panel));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_get_stats(panel, &after));
+    TEST_ASSERT_EQUAL_UINT32(16, after.coalesce_rects_in - before.coalesce_rects_in);
+    TEST_ASSERT_EQUAL_UINT32(1, after.coalesce_rects_out - before.coalesce_rects_out);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, (uint32_t)(after.coalesce_bytes_saved -
+                                                  before.coalesce_bytes_saved));
+
+    // The last band may still be on the wire in zero-copy mode
+    fill_rect(panel, 0, 0, 0, 0, BLACK);
+    vTaskDelay(pdMS_TO_TICKS(2000));
+    free(buf);
+
+    ESP_LOGI(TAG, "VISUAL CHECK: 16 red->blue ramps stacked top to bottom");
+    TEST_PASS();
+}
@@ -0,0 +1,149 @@
+// Shadow framebuffer tests. The panel is created over the emulated panel
+// IO instead of the SPI bus, so these need no display: they feed frame
+// sequences and check how many pixel bytes the driver put on the "wire".
+// They run in mock_test_app on any chip, not on the linux target, which
+// has no esp_lcd for the driver.
+#include <string.h>
+#include <stdlib.h>
+#include "esp_heap_caps.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_ili9486_panel.h"
+#include "esp_ili9486_mock_io.h"
+#include "unity.h"
+
+#define LCD_W  320
+#define LCD_H  480
+#define BAND   48      // full refresh in 10 bands, like an LVGL render buffer
+
+static esp_lcd_panel_io_handle_t s_io;
+static uint16_t *s_frame;       // the application's full framebuffer
+
+static esp_lcd_panel_handle_t shadow_panel_new(void)
+{
+    const ili9486_vendor_config_t vendor = {
+        .flags.shadow_fb = 1,
+    };
+    const esp_lcd_panel_dev_config_t cfg = {
+        .reset_gpio_num = -1,
+        .bits_per_pixel = 16,
+        .vendor_config  = (void *)&vendor,
+    };
+    // Only the byte counts matter here
+    const esp_lcd_ili9486_mock_config_t io_cfg = {
+        .flags.no_gram = 1,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_io_ili9486_mock(&io_cfg, &s_io));
+    esp_lcd_panel_handle_t panel = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_ili9486(s_io, &cfg, &panel));
+    return panel;
+}
+
+static void shadow_panel_del(esp_lcd_panel_handle_t panel)
+{
+    esp_lcd_panel_del(panel);
+    esp_lcd_panel_io_del(s_io);
+}
+
+// Send the whole framebuffer band by band; returns the pixel bytes sent
+static size_t full_refresh(esp_lcd_panel_handle_t panel)
+{
+    esp_lcd_ili9486_mock_stats_t stats;
+    esp_lcd_ili9486_mock_reset_stats(s_io);
+    for (int y = 0; y < LCD_H; y += BAND) {
+        esp_lcd_panel_draw_bitmap(panel, 0, y, LCD_W, y + BAND, s_frame + y * LCD_W);
+    }
+    esp_lcd_panel_disp_on_off(panel, true);     // drains the converter task, if enabled
+    esp_lcd_ili9486_mock_get_stats(s_io, &stats);
+    return stats.pixel_bytes;
+}
+
+static void frame_rect(int x0, int y0, int w, int h, uint16_t colour)
+{
+    for (int y = y0; y < y0 + h; y++) {
+        for (int x = x0; x < x0 + w; x++) {
+            s_frame[y * LCD_W + x] = colour;
+        }
+    }
+}
+
+TEST_CASE("shadow sends only changed tiles", "[ili9486][shadow]")
+{
+    s_frame = heap_caps_malloc(LCD_W * LCD_H * sizeof(uint16_t), MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(s_frame);
+    for (int i = 0; i < LCD_W * LCD_H; i++) s_frame[i] = rand();
+    esp_lcd_panel_handle_t panel = shadow_panel_new();
+
+    const size_t full = full_refresh(panel);
+    TEST_ASSERT_EQUAL(LCD_W * LCD_H * 3, full);
+    TEST_ASSERT_EQUAL(0, full_refresh(panel));
+
+    // One pixel changes: only its 16 x 16 tile goes out
+    s_frame[100 * LCD_W + 100] ^= 0xFFFF;
+    TEST_ASSERT_EQUAL(16 * 16 * 3, full_refresh(panel));
+
+    // Mostly static dashboard at 30 Hz for one second: a value field and
+    // a blinking dot change every frame
+    size_t total = 0;
+    for (int i = 0; i < 30; i++) {
+        frame_rect(200, 100, 40, 20, rand());
+        frame_rect(10, 400, 4, 4, (i & 1) ? 0xFFFF : 0x0000);
+        total += full_refresh(panel);
+    }
+    TEST_ASSERT_LESS_THAN(30 * full / 10, total);
+
+    // fill_rect() bypasses the shadow, so the tiles it hit are resent
+    esp_lcd_panel_ili9486_fill_rect(panel, 0, 0, 32, 16, 0x0000);
+    TEST_ASSERT_EQUAL(32 * 16 * 3, full_refresh(panel));
+
+    esp_lcd_panel_ili9486_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_get_stats(panel, &stats));
+    TEST_ASSERT_GREATER_THAN(0, stats.shadow_tiles_unchanged);
+
+    shadow_panel_del(panel);
+    free(s_frame);
+}
+
+TEST_CASE("shadow resends everything after mirror", "[ili9486][shadow]")
+{
+    s_frame = heap_caps_malloc(LCD_W * LCD_H * sizeof(uint16_t), MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(s_frame);
+    for (int i = 0; i < LCD_W * LCD_H; i++) s_frame[i] = rand();
+    esp_lcd_panel_handle_t panel = shadow_panel_new();
+
+    const size_t full = full_refresh(panel);
+    TEST_ASSERT_EQUAL(0, full_refresh(panel));
+    esp_lcd_panel_mirror(panel, true, false);
+    TEST_ASSERT_EQUAL(full, full_refresh(panel));
+
+    shadow_panel_del(panel);
+    free(s_frame);
+}
+
+static bool count_flush_done(esp_lcd_panel_handle_t panel, void *user_ctx)
+{
+    (*(volatile int *)user_ctx)++;
+    return false;
+}
+
+TEST_CASE("shadow reports unchanged draws done", "[ili9486][shadow]")
+{
+    s_frame = heap_caps_malloc(LCD_W * LCD_H * sizeof(uint16_t), MALLOC_CAP_DEFAULT);
+    TEST_ASSERT_NOT_NULL(s_frame);
+    for (int i = 0; i < LCD_W * LCD_H; i++) s_frame[i] = rand();
+    esp_lcd_panel_handle_t panel = shadow_panel_new();
+    volatile int done = 0;
+    const esp_lcd_panel_ili9486_callbacks_t cbs = {
+        .on_flush_done = count_flush_done,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK,
+                      esp_lcd_panel_ili9486_register_event_callbacks(panel, &cbs, (void *)&done));
+
+    // LVGL waits for every flush to be reported, sent or not
+    full_refresh(panel);
+    TEST_ASSERT_EQUAL(LCD_H / BAND, done);
+    TEST_ASSERT_EQUAL(0, full_refresh(panel));
+    TEST_ASSERT_EQUAL(2 * LCD_H / BAND, done);
+
+    shadow_panel_del(panel);
+    free(s_frame);
+}
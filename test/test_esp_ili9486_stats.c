@@ -0,0 +1,124 @@
+// Flush instrumentation tests on the emulated panel IO, which counts the
+// same traffic from the other end of the bus.
+#include <string.h>
+#include "esp_lcd_panel_io.h"
+#include "esp_lcd_panel_ops.h"
+#include "esp_ili9486_panel.h"
+#include "esp_ili9486_mock_io.h"
+#include "unity.h"
+
+#if CONFIG_ILI9486_ENABLE_STATS
+
+#define LCD_W  320
+#define LCD_H  480
+#define BAND   40
+
+static esp_lcd_panel_io_handle_t s_io;
+static uint16_t s_band[LCD_W * BAND];
+static volatile int s_flush_done;
+
+static esp_lcd_panel_handle_t stats_panel_new(void)
+{
+    const esp_lcd_ili9486_mock_config_t mock_config = {
+        .flags.no_gram = 1,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_io_ili9486_mock(&mock_config, &s_io));
+
+    const esp_lcd_panel_dev_config_t cfg = {
+        .reset_gpio_num = -1,
+        .bits_per_pixel = 16,
+    };
+    esp_lcd_panel_handle_t panel = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_new_panel_ili9486(s_io, &cfg, &panel));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_reset(panel));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_init(panel));
+    return panel;
+}
+
+static void stats_panel_del(esp_lcd_panel_handle_t panel)
+{
+    esp_lcd_panel_del(panel);
+    esp_lcd_panel_io_del(s_io);
+}
+
+static bool on_flush_done(esp_lcd_panel_handle_t panel, void *user_ctx)
+{
+    s_flush_done++;
+    return false;
+}
+
+TEST_CASE("stats: counters match the traffic on the wire", "[ili9486][stats]")
+{
+    esp_lcd_panel_handle_t panel = stats_panel_new();
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_reset_stats(panel));
+    esp_lcd_ili9486_mock_reset_stats(s_io);
+
+    for (int y = 0; y < LCD_H; y += BAND) {
+        esp_lcd_panel_draw_bitmap(panel, 0, y, LCD_W, y + BAND, s_band);
+    }
+    esp_lcd_panel_ili9486_fill_rect(panel, 10, 10, 50, 30, 0xF800);
+    esp_lcd_panel_invert_color(panel, true);    // drains the converter task, if enabled
+
+    esp_lcd_panel_ili9486_stats_t stats;
+    esp_lcd_ili9486_mock_stats_t wire;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_get_stats(panel, &stats));
+    esp_lcd_ili9486_mock_get_stats(s_io, &wire);
+
+    TEST_ASSERT_EQUAL(LCD_H / BAND, stats.flushes);
+    TEST_ASSERT_EQUAL(0, stats.errors);
+    TEST_ASSERT_EQUAL(wire.pixels, stats.pixels);
+    TEST_ASSERT_EQUAL(LCD_W * LCD_H + 40 * 20, stats.pixels);
+    TEST_ASSERT_EQUAL(wire.commands, stats.commands_sent);
+    TEST_ASSERT_EQUAL(wire.commands + wire.param_bytes + wire.pixel_bytes, stats.bytes_sent);
+    TEST_ASSERT_EQUAL(LCD_W * LCD_H, stats.conv_pixels);
+    TEST_ASSERT_GREATER_THAN(0, stats.conv_cycles);
+    // No flush-done event without registered callbacks
+    TEST_ASSERT_EQUAL(0, stats.wire_flushes);
+
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_reset_stats(panel));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_get_stats(panel, &stats));
+    TEST_ASSERT_EQUAL(0, stats.flushes);
+    TEST_ASSERT_EQUAL(0, stats.pixels);
+    TEST_ASSERT_EQUAL(0, stats.bytes_sent);
+    TEST_ASSERT_EQUAL(0, stats.conv_cycles);
+    TEST_ASSERT_EQUAL(0, stats.window_cmds_skipped);
+    stats_panel_del(panel);
+}
+
+TEST_CASE("stats: flushes are timed to the flush-done event", "[ili9486][stats]")
+{
+    esp_lcd_panel_handle_t panel = stats_panel_new();
+    const esp_lcd_panel_ili9486_callbacks_t cbs = {
+        .on_flush_done = on_flush_done,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_register_event_callbacks(panel, &cbs, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_reset_stats(panel));
+    s_flush_done = 0;
+
+    for (int y = 0; y < LCD_H; y += BAND) {
+        esp_lcd_panel_draw_bitmap(panel, 0, y, LCD_W, y + BAND, s_band);
+        esp_lcd_panel_disp_on_off(panel, true);
+    }
+    // A coalesced frame is one flush
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_begin_frame(panel));
+    esp_lcd_panel_draw_bitmap(panel, 0, 0, 16, 16, s_band);
+    esp_lcd_panel_draw_bitmap(panel, 100, 200, 132, 208, s_band);
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_end_frame(panel));
+    esp_lcd_panel_disp_on_off(panel, true);
+
+    esp_lcd_panel_ili9486_stats_t stats;
+    TEST_ASSERT_EQUAL(ESP_OK, esp_lcd_panel_ili9486_get_stats(panel, &stats));
+    TEST_ASSERT_EQUAL(LCD_H / BAND + 1, stats.flushes);
+    TEST_ASSERT_EQUAL(s_flush_done, stats.wire_flushes);
+    TEST_ASSERT_EQUAL(stats.flushes, stats.wire_flushes);
+    TEST_ASSERT_LESS_OR_EQUAL(stats.wire_us_total, stats.wire_us_max);
+    TEST_ASSERT_LESS_OR_EQUAL(stats.queue_us_total, stats.queue_us_max);
+#if CONFIG_ILI9486_STATS_HISTOGRAM
+    // 12 bands of 12800 pixels, then a frame of 512
+    TEST_ASSERT_EQUAL(LCD_H / BAND, stats.flush_size_hist[4]);
+    TEST_ASSERT_EQUAL(1, stats.flush_size_hist[2]);
+#endif
+    stats_panel_del(panel);
+}
+
+#endif // CONFIG_ILI9486_ENABLE_STATS
@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""Encode an image as an ILI9486 boot splash (vendor_config.splash).
+
+usage: splash_encode.py IMAGE OUTPUT [--background RRGGBB]
+
+IMAGE is a binary PPM (P6), or any format Pillow reads if it is
+installed. Colours are reduced to RGB565. An image of at most 256 colours
+is stored as palette indices, otherwise as RGB565 values; either way
+repeated pixels are run-length encoded. The background (default: the
+top-left pixel) fills the screen around the image. The format is
+described in esp_ili9486_panel.h.
+"""
+import argparse
+import struct
+import sys
+
+MAGIC = b'ISPL'
+VERSION = 1
+FLAG_PALETTE = 0x01
+RUN = 0x80
+MAX_PACKET = 128
+
+
+def read_ppm(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    fields = []
+    pos = 0
+    while len(fields) < 4:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b'#':
+            pos = data.index(b'\n', pos)
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(data[pos:end])
+        pos = end
+    if fields[0] != b'P6' or int(fields[3]) != 255:
+        sys.exit(f'{path}: only 8-bit binary PPM (P6) is read without Pillow')
+    width, height = int(fields[1]), int(fields[2])
+    pixels = data[pos + 1:pos + 1 + 3 * width * height]
+    return width, height, [tuple(pixels[i:i + 3]) for i in range(0, len(pixels), 3)]
+
+
+def read_image(path):
+    try:
+        from PIL import Image
+    except ImportError:
+        return read_ppm(path)
+    img = Image.open(path).convert('RGB')
+    return img.width, img.height, list(img.getdata())
+
+
+def rgb565(r, g, b):
+    return ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3)
+
+
+def packets(values):
+    """Split values into (run, [values]) packets of at most MAX_PACKET."""
+    out = []
+    literal = []
+    i = 0
+    while i < len(values):
+        n = 1
+        while i + n < len(values) and n < MAX_PACKET and values[i + n] == values[i]:
+            n += 1
+        # A run of two only pays off when it does not break a literal
+        if n >= 3 or (n == 2 and not literal):
+            if literal:
+                out.append((False, literal))
+                literal = []
+            out.append((True, [values[i]] * n))
+        else:
+            literal.extend(values[i:i + n])
+            while len(literal) >= MAX_PACKET:
+                out.append((False, literal[:MAX_PACKET]))
+                literal = literal[MAX_PACKET:]
+        i += n
+    if literal:
+        out.append((False, literal))
+    return out
+
+
+def encode(width, height, colors, background):
+    palette = sorted(set(colors))
+    use_palette = len(palette) <= 256
+    if use_palette:
+        index = {c: i for i, c in enumerate(palette)}
+        values = [index[c] for c in colors]
+        pack = lambda v: struct.pack('<B', v)
+    else:
+        palette = []
+        values = colors
+        pack = lambda v: struct.pack('<H', v)
+
+    out = bytearray(MAGIC)
+    out += struct.pack('<BBHHHH', VERSION, FLAG_PALETTE if use_palette else 0,
+                       width, height, background, len(palette))
+    for c in palette:
+        out += struct.pack('<H', c)
+    for run, vals in packets(values):
+        if run:
+            out.append(RUN | (len(vals) - 1))
+            out += pack(vals[0])
+        else:
+            out.append(len(vals) - 1)
+            for v in vals:
+                out += pack(v)
+    return bytes(out), use_palette
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument('image')
+    parser.add_argument('output')
+    parser.add_argument('--background', help='RRGGBB hex colour around the image')
+    args = parser.parse_args()
+
+    width, height, pixels = read_image(args.image)
+    if not 0 < width < 65536 or not 0 < height < 65536:
+        sys.exit(f'{args.image}: bad image size {width} x {height}')
+    colors = [rgb565(*p) for p in pixels]
+    if args.background:
+        v = int(args.background.lstrip('#'), 16)
+        background = rgb565(v >> 16, (v >> 8) & 0xFF, v & 0xFF)
+    else:
+        background = colors[0]
+
+    data, use_palette = encode(width, height, colors, background)
+    with open(args.output, 'wb') as f:
+        f.write(data)
+    print(f'{args.output}: {width} x {height}, '
+          f'{"palette" if use_palette else "RGB565"}, {len(data)} bytes '
+          f'({100 * len(data) / (2 * width * height):.1f} % of raw RGB565)')
+
+
+if __name__ == '__main__':
+    main()